@@ -14,5 +14,14 @@
 #include "TemperatureAccespoint.h"
 #include "TemperaturePreferences.h"
 #include "TemperatureWiFiHelper.h"
+#include "TemperatureFixedString.h"
+#include "TemperatureLineProtocol.h"
+#include "TemperatureLogger.h"
+#include "TemperatureScheduler.h"
+#include "TemperatureRecordWriter.h"
+#include "TemperatureInfluxWriter.h"
+#include "TemperatureUplink.h"
+#include "TemperatureTransmitter.h"
+#include <sys/time.h>
 
 #endif
\ No newline at end of file
@@ -15,6 +15,27 @@
 // Temperature Sensor
 #define ONE_WIRE_BUS 15
 
+// Schedule, samples on every full minute and uploads the average every 10 minutes
+#define SAMPLE_PERIOD_MS 60000
+#define SAMPLES_PER_UPLOAD 10
+#define UPLOAD_JITTER_MS 30000
+#define SAMPLE_LATE_TOLERANCE_MS 2000
+// Points per write request, one point every 10 minutes is sent right away, a backlog in batches
+#define UPLOAD_BATCH_SIZE 4
+
+// Uplink, failed writes are retried with exponential backoff, older points are sent at most every 5 seconds
+#define UPLINK_INITIAL_BACKOFF_MS 5000
+#define UPLINK_MAX_BACKOFF_MS 300000
+#define UPLINK_BACKFILL_INTERVAL_MS 5000
+
+// A write blocks for the DNS lookup and the TCP connect of a new connection (the client reuses it)
+// and then up to the response timeout, so none is started this close to the next sample. The TLS
+// handshake is not limited by the client, if it takes longer the next sample is late and its slot is skipped.
+// With the upload jitter below 30 s the fresh point is always sent before the guard.
+#define UPLINK_WRITE_TIMEOUT_MS 5000
+#define UPLINK_CONNECT_BUDGET_MS 10000
+#define UPLINK_SEND_GUARD_MS (UPLINK_CONNECT_BUDGET_MS + UPLINK_WRITE_TIMEOUT_MS)
+
 // Fail Codes
 #define FAIL_MESSAGE_WIFI_CONNECT 1
 #define INFLUX_PARAMETER_ERROR 2
@@ -25,7 +46,4 @@
 //Reset Button  
 #define RESET_BUTTON_PIN 13
 
-//Configuration Printout
-#define printoutConfiguration(x) Serial.print("[CONF] " + String(x))
-
 #endif
\ No newline at end of file
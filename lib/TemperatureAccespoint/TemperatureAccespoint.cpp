@@ -2,12 +2,28 @@
 
 WebServer server(WEB_SERVER_PORT);
 
+/**
+ * @brief Copy an input of the web page into a fixed string
+ *
+ * @param input the input
+ * @param value the fixed string
+ * @return true if the input fits into the fixed string
+ * @return false if the input is too long, the fixed string is not changed
+ */
+template <size_t N>
+static bool readInput(const String &input, TemperatureFixedString<N> *value)
+{
+    if (input.length() > value->capacity()) return false;
+    value->assign(input.c_str());
+    return true;
+}
+
 /**
  * @brief Construct a new Temperature Accespoint
  * 
  * @param ssid the name of the WiFi (wifi)
  */
-TemperatureAccespoint::TemperatureAccespoint(String ssid)
+TemperatureAccespoint::TemperatureAccespoint(const char *ssid)
 {
     this->ssid = ssid;
 }
@@ -17,8 +33,8 @@ TemperatureAccespoint::TemperatureAccespoint(String ssid)
  */
 void TemperatureAccespoint::printConnectionInfo()
 {
-    printoutWifiAP("Connected to " + WiFi.SSID() + "\n");
-    printoutWifiAP("Go To https://" + WiFi.localIP().toString() + "/ to configure the device\n");
+    logInfo(LOG_WIFIAP, "Connected to", WiFi.SSID().c_str());
+    logInfo(LOG_WIFIAP, "Go To this address to configure the device", WiFi.softAPIP().toString().c_str());
 }
 
 
@@ -34,35 +50,44 @@ void TemperatureAccespoint::start(String webseiteStringHTML, String *wifiScanSSI
     WiFi.disconnect();
     WiFi.mode(WIFI_AP);
     WiFi.softAP(ssid.c_str());
-    Serial.println(WiFi.localIP());
+    logInfo(LOG_WIFIAP, "Accespoint started", ssid.c_str());
 
     server.on("/", HTTP_GET, [webseiteStringHTML]()
               { server.send(200, "text/html", webseiteStringHTML); });
-    server.on("/input", HTTP_GET, [wifiScanSSIDs, settings]()
+    server.on("/input", HTTP_GET, [this, wifiScanSSIDs, settings]()
               {
-            String ssidNumber = server.arg("ssid");
-            int ssidInt = ssidNumber.toInt();
-            String ssid = wifiScanSSIDs[ssidInt];
-            String passwd = server.arg("passwd");
-            String influxUrl = server.arg("influxUrl");
-            String influxToken = server.arg("influxToken");
-            String influxOrganisation = server.arg("influxOrganisation");
-            String influxBucket = server.arg("influxBucket");
+            int ssidInt = server.arg("ssid").toInt();
+            const char *tooLong = nullptr;
+            if(!readInput(wifiScanSSIDs[ssidInt], &inputSsid)) tooLong = "SSID";
+            else if(!readInput(server.arg("passwd"), &inputPasswd)) tooLong = "Password";
+            else if(!readInput(server.arg("influxUrl"), &inputInfluxUrl)) tooLong = "InfluxDB URL";
+            else if(!readInput(server.arg("influxToken"), &inputInfluxToken)) tooLong = "InfluxDB Token";
+            else if(!readInput(server.arg("influxOrganisation"), &inputInfluxOrgranisation)) tooLong = "InfluxDB Organisation";
+            else if(!readInput(server.arg("influxBucket"), &inputInfluxBucket)) tooLong = "InfluxDB Bucket";
+
+            // A cut value would be saved and fail later, so nothing is saved
+            if(tooLong != nullptr)
+            {
+                logError(LOG_WIFIAP, "Input too long, configuration not saved", tooLong);
+                server.send(400, "text/html", "<!DOCTYPE HTML><html><body>" + String(tooLong) + " is too long, nothing was saved.<br><a href=\"/\">Back</a></body></html>");
+                return;
+            }
 
-            if(ssid != "") Serial.println("SSID: " + ssid);
-            if(passwd != "") Serial.println("Password: " + passwd);
-            if(influxUrl != "") Serial.println("InfluxDB URL: " + influxUrl);
-            if(influxToken != "") Serial.println("InfluxDB Token: " + influxToken);
-            if(influxOrganisation != "") Serial.println("InfluxDB Organisation: " + influxOrganisation);
-            if(influxBucket != "") Serial.println("InfluxDB Bucket: " + influxBucket);
+            if(!inputSsid.isEmpty()) logInfo(LOG_WIFIAP, "SSID", inputSsid.c_str());
+            if(!inputPasswd.isEmpty()) logInfo(LOG_WIFIAP, "Password", logSecret(inputPasswd.c_str()));
+            if(!inputInfluxUrl.isEmpty()) logInfo(LOG_WIFIAP, "InfluxDB URL", inputInfluxUrl.c_str());
+            if(!inputInfluxToken.isEmpty()) logInfo(LOG_WIFIAP, "InfluxDB Token", logSecret(inputInfluxToken.c_str()));
+            if(!inputInfluxOrgranisation.isEmpty()) logInfo(LOG_WIFIAP, "InfluxDB Organisation", inputInfluxOrgranisation.c_str());
+            if(!inputInfluxBucket.isEmpty()) logInfo(LOG_WIFIAP, "InfluxDB Bucket", inputInfluxBucket.c_str());
 
-            settings->writeWiFiConfiguration(ssid, passwd);
-            settings->writeInfluxDBConfiguration(influxUrl, influxToken, influxOrganisation, influxBucket);
+            settings->writeWiFiConfiguration(inputSsid.c_str(), inputPasswd.c_str());
+            settings->writeInfluxDBConfiguration(inputInfluxUrl.c_str(), inputInfluxToken.c_str(), inputInfluxOrgranisation.c_str(), inputInfluxBucket.c_str());
             settings->setConfiguration(true);
 
             server.send(200, "text/html", "Configuration done");
-            printoutWifiAP("Setup done Restarting now\n");
+            logInfo(LOG_WIFIAP, "Setup done Restarting now");
             delay(1000);
+            logger.drain();
             ESP.restart(); });
     server.begin();
 }
@@ -13,29 +13,28 @@
 #include <WebServer.h>
 #include <ESPAsyncWebServer.h>
 #include "TemperaturePreferences.h"
+#include "TemperatureLogger.h"
 
 #define WEB_SERVER_PORT 80
 
-#define printoutWifiAP(x) Serial.print("[WIFIAP] " + String(x));
-
 class TemperatureAccespoint
 {
 public:
-    String inputSsid;
-    String inputPasswd;
-    String inputInfluxUrl;
-    String inputInfluxToken;
-    String inputInfluxOrgranisation;
-    String inputInfluxBucket;
+    WifiSsidString inputSsid;
+    WifiPasswordString inputPasswd;
+    InfluxUrlString inputInfluxUrl;
+    InfluxTokenString inputInfluxToken;
+    InfluxOrganisationString inputInfluxOrgranisation;
+    InfluxBucketString inputInfluxBucket;
 
-    TemperatureAccespoint(String ssid);
+    TemperatureAccespoint(const char *ssid);
 
     void printConnectionInfo();
     void start(String webseiteStringHTML, String *wifiScanSSIDs, TemperaturePreferences *settings);
     void handle();
 
 private:
-    String ssid;
+    WifiSsidString ssid;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+ * @brief Temperature Fixed String
+ * @details This Programm is used to store Strings with a fixed capacity without using the heap
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureFixedString_h
+#define TemperatureFixedString_h
+
+#include <stddef.h>
+#include <string.h>
+
+template <size_t N>
+class TemperatureFixedString
+{
+public:
+    TemperatureFixedString() { clear(); }
+    TemperatureFixedString(const char *value) { assign(value); }
+
+    /**
+     * @brief Replace the content, longer values are truncated to the capacity
+     *
+     * @param value the new content
+     */
+    void assign(const char *value)
+    {
+        clear();
+        append(value);
+    }
+
+    /**
+     * @brief Append a text, longer values are truncated to the capacity
+     *
+     * @param value the text to append
+     */
+    void append(const char *value)
+    {
+        if (value == nullptr) return;
+        size_t available = N - len;
+        size_t count = strnlen(value, available);
+        memcpy(data + len, value, count);
+        len += count;
+        data[len] = '\0';
+    }
+
+    /**
+     * @brief Remove the content
+     */
+    void clear()
+    {
+        len = 0;
+        data[0] = '\0';
+    }
+
+    /**
+     * @brief Raw buffer to be filled by C APIs, call update() afterwards
+     *
+     * @return char* the buffer with capacity() + 1 bytes
+     */
+    char *buffer() { return data; }
+
+    /**
+     * @brief Recalculate the length after the buffer was written directly
+     */
+    void update()
+    {
+        data[N] = '\0';
+        len = strlen(data);
+    }
+
+    const char *c_str() const { return data; }
+    size_t length() const { return len; }
+    size_t capacity() const { return N; }
+    bool isEmpty() const { return len == 0; }
+    bool equals(const char *value) const { return value != nullptr && strcmp(data, value) == 0; }
+
+    TemperatureFixedString &operator=(const char *value)
+    {
+        assign(value);
+        return *this;
+    }
+
+    bool operator==(const char *value) const { return equals(value); }
+    bool operator!=(const char *value) const { return !equals(value); }
+
+private:
+    char data[N + 1];
+    size_t len;
+};
+
+#endif
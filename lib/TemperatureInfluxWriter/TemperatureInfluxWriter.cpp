@@ -0,0 +1,28 @@
+#include "TemperatureInfluxWriter.h"
+
+/**
+ * @brief Construct a new Temperature Influx Writer
+ *
+ * @param client the configured InfluxDB client
+ */
+TemperatureInfluxWriter::TemperatureInfluxWriter(InfluxDBClient *client)
+{
+    this->client = client;
+}
+
+/**
+ * @brief Write records, the client still uses the heap for its buffer and the HTTP request
+ *
+ * @param records the records, separated by '\n'
+ * @param retryAfterMs always 0, the client does not expose the Retry-After header
+ * @return int the HTTP status code, 0 if the server was not reachable
+ */
+int TemperatureInfluxWriter::write(const char *records, uint32_t *retryAfterMs)
+{
+    *retryAfterMs = 0;
+    if (client->writeRecord(records)) return 204;
+
+    // Negative codes are connection errors of the HTTPClient
+    int status = client->getLastStatusCode();
+    return status > 0 ? status : 0;
+}
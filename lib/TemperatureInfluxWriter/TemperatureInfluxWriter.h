@@ -0,0 +1,26 @@
+/**
+ * @brief Temperature Influx Writer
+ * @details This Programm is used to write records with the InfluxDB client
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureInfluxWriter_h
+#define TemperatureInfluxWriter_h
+
+#include <InfluxDbClient.h>
+#include "TemperatureRecordWriter.h"
+
+class TemperatureInfluxWriter : public TemperatureRecordWriter
+{
+public:
+    TemperatureInfluxWriter(InfluxDBClient *client);
+
+    int write(const char *records, uint32_t *retryAfterMs) override;
+
+private:
+    InfluxDBClient *client;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "TemperatureLineProtocol.h"
+
+#include <math.h>
+#include <stdio.h>
+
+/**
+ * @brief Construct a new Temperature Line Protocol
+ *
+ * @param measurement the name of the measurement
+ */
+TemperatureLineProtocol::TemperatureLineProtocol(const char *measurement)
+{
+    appendEscaped(measurement, ", ");
+}
+
+/**
+ * @brief Add a tag to every encoded line
+ *
+ * @param key the name of the tag
+ * @param value the value of the tag
+ */
+void TemperatureLineProtocol::addTag(const char *key, const char *value)
+{
+    prefix.append(",");
+    appendEscaped(key, ",= ");
+    prefix.append("=");
+    appendEscaped(value, ",= ");
+}
+
+/**
+ * @brief Encode a measurement without a timestamp, the server time is used
+ *
+ * @param temperature the temperature in °C
+ * @param rssi the signal strength of the WiFi
+ * @return const char* the line, valid until the next call
+ */
+const char *TemperatureLineProtocol::encode(double temperature, long rssi)
+{
+    return encode(temperature, rssi, 0);
+}
+
+/**
+ * @brief Encode a measurement
+ *
+ * @param temperature the temperature in °C, left out if it is not a number
+ * @param rssi the signal strength of the WiFi
+ * @param timestamp the timestamp in the write precision of the client, 0 for none
+ * @return const char* the line, valid until the next call
+ */
+const char *TemperatureLineProtocol::encode(double temperature, long rssi, unsigned long timestamp)
+{
+    char *buffer = line.buffer();
+    size_t size = line.capacity() + 1;
+    int written;
+
+    if (isnan(temperature))
+        written = snprintf(buffer, size, "%s rssid=%ldi", prefix.c_str(), rssi);
+    else
+        written = snprintf(buffer, size, "%s temperature=%.2f,rssid=%ldi", prefix.c_str(), temperature, rssi);
+
+    if (timestamp != 0 && written > 0 && (size_t)written < size)
+        snprintf(buffer + written, size - written, " %lu", timestamp);
+
+    line.update();
+    return line.c_str();
+}
+
+/**
+ * @brief The last encoded line
+ */
+const char *TemperatureLineProtocol::c_str() const
+{
+    return line.c_str();
+}
+
+/**
+ * @brief The length of the last encoded line
+ */
+size_t TemperatureLineProtocol::length() const
+{
+    return line.length();
+}
+
+/**
+ * @brief Append a value to the prefix and escape the special characters
+ *
+ * @param value the value
+ * @param special the characters which have to be escaped
+ */
+void TemperatureLineProtocol::appendEscaped(const char *value, const char *special)
+{
+    char character[3] = {'\\', '\0', '\0'};
+    for (; *value != '\0'; value++)
+    {
+        character[1] = *value;
+        prefix.append(strchr(special, *value) != nullptr ? character : character + 1);
+    }
+}
@@ -0,0 +1,35 @@
+/**
+ * @brief Temperature Line Protocol
+ * @details This Programm is used to encode the Temperature in the InfluxDB Line Protocol without using the heap
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureLineProtocol_h
+#define TemperatureLineProtocol_h
+
+#include "TemperatureFixedString.h"
+
+#define LINE_PROTOCOL_PREFIX_LENGTH 96
+#define LINE_PROTOCOL_MAX_LENGTH 160
+
+class TemperatureLineProtocol
+{
+public:
+    TemperatureLineProtocol(const char *measurement);
+
+    void addTag(const char *key, const char *value);
+    const char *encode(double temperature, long rssi);
+    const char *encode(double temperature, long rssi, unsigned long timestamp);
+    const char *c_str() const;
+    size_t length() const;
+
+private:
+    void appendEscaped(const char *value, const char *special);
+
+    TemperatureFixedString<LINE_PROTOCOL_PREFIX_LENGTH> prefix;
+    TemperatureFixedString<LINE_PROTOCOL_MAX_LENGTH> line;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "TemperatureLogger.h"
+
+TemperatureLogger logger;
+
+static const char *levelNames[] = {"NONE", "ERROR", "WARN", "INFO", "DEBUG"};
+static const char *subsystemNames[] = {"MAIN", "CONF", "WIFI", "WIFIAP", "INFLUX", "SENSOR"};
+
+TemperatureLogger::TemperatureLogger()
+{
+    droppedRecords = 0;
+    reportedDroppedRecords = 0;
+    rateWindow = 0;
+    rateCount = 0;
+    task = nullptr;
+}
+
+/**
+ * @brief Start the task which prints the records to the Serial
+ */
+void TemperatureLogger::begin()
+{
+    if (task == nullptr)
+        xTaskCreate(drainTask, "logger", LOG_TASK_STACK_SIZE, this, LOG_TASK_PRIORITY, &task);
+}
+
+/**
+ * @brief Print all buffered records, may block on the Serial
+ */
+void TemperatureLogger::drain()
+{
+    TemperatureLogRecord record;
+    while (records.pop(record)) print(record);
+
+    uint32_t dropped = droppedRecords.load();
+    uint32_t reported = reportedDroppedRecords.load();
+    if (dropped != reported)
+    {
+        reportedDroppedRecords = dropped;
+        Serial.printf("[LOG] %lu records dropped\n", (unsigned long)(dropped - reported));
+    }
+}
+
+/**
+ * @brief Get the number of records which were dropped because the buffer was full or the rate was too high
+ */
+uint32_t TemperatureLogger::getDroppedRecords()
+{
+    return droppedRecords.load();
+}
+
+/**
+ * @brief Log a message
+ *
+ * @param level the level
+ * @param subsystem the subsystem
+ * @param message the message, has to be a string literal
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message)
+{
+    TemperatureLogRecord record;
+    record.level = level;
+    record.subsystem = subsystem;
+    record.type = LOG_VALUE_NONE;
+    record.message = message;
+    push(record);
+}
+
+/**
+ * @brief Log a message with a number
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, int value)
+{
+    write(level, subsystem, message, (long)value);
+}
+
+/**
+ * @brief Log a message with a number
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, unsigned int value)
+{
+    write(level, subsystem, message, (long)value);
+}
+
+/**
+ * @brief Log a message with a number
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, long value)
+{
+    TemperatureLogRecord record;
+    record.level = level;
+    record.subsystem = subsystem;
+    record.type = LOG_VALUE_NUMBER;
+    record.message = message;
+    record.number = value;
+    push(record);
+}
+
+/**
+ * @brief Log a message with a number
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, unsigned long value)
+{
+    write(level, subsystem, message, (long)value);
+}
+
+/**
+ * @brief Log a message with a decimal number
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, double value)
+{
+    TemperatureLogRecord record;
+    record.level = level;
+    record.subsystem = subsystem;
+    record.type = LOG_VALUE_DECIMAL;
+    record.message = message;
+    record.decimal = value;
+    push(record);
+}
+
+/**
+ * @brief Log a message with a text, the text is copied and cut to LOG_TEXT_LENGTH - 1 characters
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, const char *value)
+{
+    TemperatureLogRecord record;
+    record.level = level;
+    record.subsystem = subsystem;
+    record.type = LOG_VALUE_TEXT;
+    record.message = message;
+    record.truncated = strnlen(value, LOG_TEXT_LENGTH) == LOG_TEXT_LENGTH;
+    strncpy(record.text, value, LOG_TEXT_LENGTH - 1);
+    record.text[LOG_TEXT_LENGTH - 1] = '\0';
+    push(record);
+}
+
+/**
+ * @brief Log a message with a secret, only the length of the secret is printed
+ */
+void TemperatureLogger::write(uint8_t level, uint8_t subsystem, const char *message, TemperatureLogSecret value)
+{
+    TemperatureLogRecord record;
+    record.level = level;
+    record.subsystem = subsystem;
+    record.type = LOG_VALUE_SECRET;
+    record.message = message;
+    record.number = value.value == nullptr ? 0 : strlen(value.value);
+    push(record);
+}
+
+/**
+ * @brief The task which drains the buffer
+ *
+ * @param logger the TemperatureLogger
+ */
+void TemperatureLogger::drainTask(void *logger)
+{
+    for (;;)
+    {
+        ((TemperatureLogger *)logger)->drain();
+        vTaskDelay(pdMS_TO_TICKS(LOG_TASK_INTERVAL_MS));
+    }
+}
+
+/**
+ * @brief Check if the rate limit allows another record in this second
+ *
+ * @param now the current time in milliseconds
+ */
+bool TemperatureLogger::allowRecord(uint32_t now)
+{
+    uint32_t window = now / 1000;
+    if (rateWindow.load(std::memory_order_relaxed) != window)
+    {
+        rateWindow.store(window, std::memory_order_relaxed);
+        rateCount.store(0, std::memory_order_relaxed);
+    }
+    return rateCount.fetch_add(1, std::memory_order_relaxed) < LOG_MAX_RECORDS_PER_SECOND;
+}
+
+/**
+ * @brief Add a record to the buffer, the record is dropped if there is no space left
+ *
+ * @param record the record
+ */
+void TemperatureLogger::push(TemperatureLogRecord &record)
+{
+    record.timestamp = millis();
+    if (!allowRecord(record.timestamp) || !records.push(record)) droppedRecords++;
+}
+
+/**
+ * @brief Format a record and print it to the Serial
+ *
+ * @param record the record
+ */
+void TemperatureLogger::print(const TemperatureLogRecord &record)
+{
+    char line[LOG_LINE_LENGTH];
+    size_t size = sizeof(line) - 1;
+    int length = snprintf(line, size, "[%lu][%s][%s] %s", (unsigned long)record.timestamp,
+                          levelNames[record.level], subsystemNames[record.subsystem], record.message);
+    if (length < 0) return;
+
+    if ((size_t)length < size)
+    {
+        switch (record.type)
+        {
+        case LOG_VALUE_NUMBER:
+            length += snprintf(line + length, size - length, ": %ld", record.number);
+            break;
+        case LOG_VALUE_DECIMAL:
+            length += snprintf(line + length, size - length, ": %.2f", record.decimal);
+            break;
+        case LOG_VALUE_TEXT:
+            length += snprintf(line + length, size - length, record.truncated ? ": %s..." : ": %s", record.text);
+            break;
+        case LOG_VALUE_SECRET:
+            length += snprintf(line + length, size - length, record.number > 0 ? ": <redacted, %ld chars>" : ": <empty>", record.number);
+            break;
+        }
+    }
+
+    if ((size_t)length >= size) length = size - 1;
+    line[length++] = '\n';
+    Serial.write((const uint8_t *)line, length);
+}
@@ -0,0 +1,135 @@
+/**
+ * @brief Temperature Logger
+ * @details This Programm is used to log without blocking, the records are printed by a low priority task
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureLogger_h
+#define TemperatureLogger_h
+
+#include <Arduino.h>
+#include "TemperatureRingBuffer.h"
+#include "TemperatureLineProtocol.h"
+
+// Levels
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Disabled levels are removed at compile time, override with -D LOG_LEVEL=... in the build_flags
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Subsystems
+#define LOG_MAIN 0
+#define LOG_CONF 1
+#define LOG_WIFI 2
+#define LOG_WIFIAP 3
+#define LOG_INFLUX 4
+#define LOG_SENSOR 5
+
+// Buffer, a text value holds a whole line of the line protocol, longer texts are printed with "..."
+#define LOG_BUFFER_SIZE 32
+#define LOG_TEXT_LENGTH (LINE_PROTOCOL_MAX_LENGTH + 1)
+#define LOG_LINE_LENGTH 256
+#define LOG_MAX_RECORDS_PER_SECOND 40
+
+// Drain Task, below the Arduino loopTask (priority 1), so it only prints while the loop waits
+#define LOG_TASK_STACK_SIZE 3072
+#define LOG_TASK_PRIORITY tskIDLE_PRIORITY
+#define LOG_TASK_INTERVAL_MS 20
+
+#define LOG_VALUE_NONE 0
+#define LOG_VALUE_NUMBER 1
+#define LOG_VALUE_DECIMAL 2
+#define LOG_VALUE_TEXT 3
+#define LOG_VALUE_SECRET 4
+
+/**
+ * @brief A value which is never printed, only if it is set
+ */
+struct TemperatureLogSecret
+{
+    const char *value;
+};
+
+#define logSecret(x) (TemperatureLogSecret{(x)})
+
+struct TemperatureLogRecord
+{
+    uint32_t timestamp;
+    uint8_t level;
+    uint8_t subsystem;
+    uint8_t type;
+    bool truncated;
+    const char *message;
+    long number;
+    double decimal;
+    char text[LOG_TEXT_LENGTH];
+};
+
+class TemperatureLogger
+{
+public:
+    TemperatureLogger();
+
+    void begin();
+    void drain();
+    uint32_t getDroppedRecords();
+
+    void write(uint8_t level, uint8_t subsystem, const char *message);
+    void write(uint8_t level, uint8_t subsystem, const char *message, int value);
+    void write(uint8_t level, uint8_t subsystem, const char *message, unsigned int value);
+    void write(uint8_t level, uint8_t subsystem, const char *message, long value);
+    void write(uint8_t level, uint8_t subsystem, const char *message, unsigned long value);
+    void write(uint8_t level, uint8_t subsystem, const char *message, double value);
+    void write(uint8_t level, uint8_t subsystem, const char *message, const char *value);
+    void write(uint8_t level, uint8_t subsystem, const char *message, TemperatureLogSecret value);
+
+private:
+    static void drainTask(void *logger);
+    bool allowRecord(uint32_t now);
+    void push(TemperatureLogRecord &record);
+    void print(const TemperatureLogRecord &record);
+
+    TemperatureRingBuffer<TemperatureLogRecord, LOG_BUFFER_SIZE> records;
+    std::atomic<uint32_t> droppedRecords;
+    std::atomic<uint32_t> reportedDroppedRecords;
+    std::atomic<uint32_t> rateWindow;
+    std::atomic<uint32_t> rateCount;
+    TaskHandle_t task;
+};
+
+extern TemperatureLogger logger;
+
+// The message has to be a string literal, it is printed later by the drain task
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define logError(subsystem, ...) logger.write(LOG_LEVEL_ERROR, subsystem, __VA_ARGS__)
+#else
+#define logError(subsystem, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define logWarn(subsystem, ...) logger.write(LOG_LEVEL_WARN, subsystem, __VA_ARGS__)
+#else
+#define logWarn(subsystem, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define logInfo(subsystem, ...) logger.write(LOG_LEVEL_INFO, subsystem, __VA_ARGS__)
+#else
+#define logInfo(subsystem, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define logDebug(subsystem, ...) logger.write(LOG_LEVEL_DEBUG, subsystem, __VA_ARGS__)
+#else
+#define logDebug(subsystem, ...) do {} while (0)
+#endif
+
+#endif
@@ -13,11 +13,11 @@ TemperaturePreferences::TemperaturePreferences(const char* folder){
  * @param ssid the SSID of the Wifi Network
  * @param passwd the Password of the Wifi Network
  */
-void TemperaturePreferences::writeWiFiConfiguration(String ssid, String passwd)
+void TemperaturePreferences::writeWiFiConfiguration(const char *ssid, const char *passwd)
 {
     preferences.begin(folder, false);
-    if(ssid != "") preferences.putString(PREF_KEY_WIFI_SSID, ssid);
-    if(passwd != "") preferences.putString(PREF_KEY_WIFI_PASSWORD, passwd);
+    if(ssid[0] != '\0') preferences.putString(PREF_KEY_WIFI_SSID, ssid);
+    if(passwd[0] != '\0') preferences.putString(PREF_KEY_WIFI_PASSWORD, passwd);
     preferences.end();
 }
 
@@ -29,13 +29,13 @@ void TemperaturePreferences::writeWiFiConfiguration(String ssid, String passwd)
  * @param influxOrganisation the Organisation of the InfluxDB
  * @param influxBucket the Bucket of the InfluxDB
  */
-void TemperaturePreferences::writeInfluxDBConfiguration(String influxUrl, String influxToken, String influxOrganisation, String influxBucket)
+void TemperaturePreferences::writeInfluxDBConfiguration(const char *influxUrl, const char *influxToken, const char *influxOrganisation, const char *influxBucket)
 {
     preferences.begin(folder, false);
-    if(influxUrl != "") preferences.putString(PERF_KEY_INFLUX_URL, influxUrl);
-    if(influxToken != "") preferences.putString(PERF_KEY_INFLUX_TOKEN, influxToken);
-    if(influxOrganisation != "") preferences.putString(PERF_KEY_INFLUX_ORGANISATION, influxOrganisation);
-    if(influxBucket != "") preferences.putString(PERF_KEY_INFLUX_BUCKET, influxBucket);
+    if(influxUrl[0] != '\0') preferences.putString(PERF_KEY_INFLUX_URL, influxUrl);
+    if(influxToken[0] != '\0') preferences.putString(PERF_KEY_INFLUX_TOKEN, influxToken);
+    if(influxOrganisation[0] != '\0') preferences.putString(PERF_KEY_INFLUX_ORGANISATION, influxOrganisation);
+    if(influxBucket[0] != '\0') preferences.putString(PERF_KEY_INFLUX_BUCKET, influxBucket);
     preferences.end();
 }
 
@@ -72,14 +72,18 @@ void TemperaturePreferences::setErrorCode(int failCode)
  * @param organisation the Organisation of the InfluxDB
  * @param bucket the Bucket of the InfluxDB
  */
-void TemperaturePreferences::getInfluxParameter(String *url, String *token, String *organisation, String *bucket)
+void TemperaturePreferences::getInfluxParameter(InfluxUrlString *url, InfluxTokenString *token, InfluxOrganisationString *organisation, InfluxBucketString *bucket)
 {
     preferences.begin(folder, false);
-    *url = preferences.getString(PERF_KEY_INFLUX_URL, "No URL");
-    *token = preferences.getString(PERF_KEY_INFLUX_TOKEN, "No Token");
-    *organisation = preferences.getString(PERF_KEY_INFLUX_ORGANISATION, "No Organisation");
-    *bucket = preferences.getString(PERF_KEY_INFLUX_BUCKET, "No Bucket");
+    readString(PERF_KEY_INFLUX_URL, url->buffer(), url->capacity() + 1, "No URL");
+    readString(PERF_KEY_INFLUX_TOKEN, token->buffer(), token->capacity() + 1, "No Token");
+    readString(PERF_KEY_INFLUX_ORGANISATION, organisation->buffer(), organisation->capacity() + 1, "No Organisation");
+    readString(PERF_KEY_INFLUX_BUCKET, bucket->buffer(), bucket->capacity() + 1, "No Bucket");
     preferences.end();
+    url->update();
+    token->update();
+    organisation->update();
+    bucket->update();
 }
 
 /**
@@ -88,12 +92,14 @@ void TemperaturePreferences::getInfluxParameter(String *url, String *token, Stri
  * @param ssid the SSID of the Wifi Network
  * @param passwd the Password of the Wifi Network
  */
-void TemperaturePreferences::getWiFiParameter(String *ssid, String *passwd)
+void TemperaturePreferences::getWiFiParameter(WifiSsidString *ssid, WifiPasswordString *passwd)
 {
     preferences.begin(folder, false);
-    *ssid = preferences.getString(PREF_KEY_WIFI_SSID, "No SSID");
-    *passwd = preferences.getString(PREF_KEY_WIFI_PASSWORD, "No Password");
+    readString(PREF_KEY_WIFI_SSID, ssid->buffer(), ssid->capacity() + 1, "No SSID");
+    readString(PREF_KEY_WIFI_PASSWORD, passwd->buffer(), passwd->capacity() + 1, "No Password");
     preferences.end();
+    ssid->update();
+    passwd->update();
 }
 
 /**
@@ -134,3 +140,21 @@ void TemperaturePreferences::updateConfigurationStatus(){
     hasConfigurationStatus = preferences.getBool(PERF_KEY_HAS_CONFIGURATION, false);
     preferences.end();
 }
+
+/**
+ * @brief Read a String into a fixed Buffer without using the heap
+ *
+ * @param key the Key of the Preference
+ * @param value the Buffer to write to
+ * @param maxLen the Size of the Buffer
+ * @param fallback the Value if the Key is missing or too long
+ */
+void TemperaturePreferences::readString(const char *key, char *value, size_t maxLen, const char *fallback){
+    if(preferences.getString(key, value, maxLen) > 0) return;
+
+    // A value which was stored by an older firmware may not fit, then it has to be configured again
+    if(preferences.isKey(key)) logError(LOG_CONF, "Stored value too long, configure it again", key);
+
+    strncpy(value, fallback, maxLen - 1);
+    value[maxLen - 1] = '\0';
+}
\ No newline at end of file
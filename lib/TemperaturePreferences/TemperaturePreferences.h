@@ -10,6 +10,8 @@
 #define TemperaturePreferences_h
 
 #include <Preferences.h>
+#include "TemperatureFixedString.h"
+#include "TemperatureLogger.h"
 
 #define PERF_KEY_HAS_CONFIGURATION "hconf"
 #define PREF_KEY_WIFI_SSID "ssid"
@@ -21,21 +23,37 @@
 #define PERF_KEY_INFLUX_BUCKET "buck"
 #define PERF_KEY_FAIL "fail"
 
+// Maximum Lengths of the stored Parameters
+#define PREF_LENGTH_WIFI_SSID 32
+#define PREF_LENGTH_WIFI_PASSWORD 64
+#define PREF_LENGTH_INFLUX_URL 128
+#define PREF_LENGTH_INFLUX_TOKEN 128
+#define PREF_LENGTH_INFLUX_ORGANISATION 64
+#define PREF_LENGTH_INFLUX_BUCKET 64
+
+typedef TemperatureFixedString<PREF_LENGTH_WIFI_SSID> WifiSsidString;
+typedef TemperatureFixedString<PREF_LENGTH_WIFI_PASSWORD> WifiPasswordString;
+typedef TemperatureFixedString<PREF_LENGTH_INFLUX_URL> InfluxUrlString;
+typedef TemperatureFixedString<PREF_LENGTH_INFLUX_TOKEN> InfluxTokenString;
+typedef TemperatureFixedString<PREF_LENGTH_INFLUX_ORGANISATION> InfluxOrganisationString;
+typedef TemperatureFixedString<PREF_LENGTH_INFLUX_BUCKET> InfluxBucketString;
+
 class TemperaturePreferences
 {
 public:
     TemperaturePreferences(const char* folder);
-    void writeWiFiConfiguration(String ssid, String passwd);
-    void writeInfluxDBConfiguration(String influxUrl, String influxToken, String influxOrganisation, String influxBucket);
+    void writeWiFiConfiguration(const char *ssid, const char *passwd);
+    void writeInfluxDBConfiguration(const char *influxUrl, const char *influxToken, const char *influxOrganisation, const char *influxBucket);
     void setConfiguration(bool hasConfiguration);
-    void getInfluxParameter(String *url, String *token, String *organisation, String *bucket);
-    void getWiFiParameter(String *ssid, String *passwd);
+    void getInfluxParameter(InfluxUrlString *url, InfluxTokenString *token, InfluxOrganisationString *organisation, InfluxBucketString *bucket);
+    void getWiFiParameter(WifiSsidString *ssid, WifiPasswordString *passwd);
     int getLastErrorCode();
     void setErrorCode(int errorcode);
     bool hasConfiguration();
     void clear();
     void updateConfigurationStatus();
 private:
+    void readString(const char *key, char *value, size_t maxLen, const char *fallback);
     const char* folder;
     bool hasConfigurationStatus;
 };
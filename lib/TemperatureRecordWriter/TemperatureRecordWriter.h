@@ -0,0 +1,29 @@
+/**
+ * @brief Temperature Record Writer
+ * @details This Programm is used to hide the InfluxDB client behind an interface, so the upload can be replaced on the host
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureRecordWriter_h
+#define TemperatureRecordWriter_h
+
+#include <stdint.h>
+
+class TemperatureRecordWriter
+{
+public:
+    virtual ~TemperatureRecordWriter() {}
+
+    /**
+     * @brief Write records in the InfluxDB Line Protocol
+     *
+     * @param records the records, separated by '\n'
+     * @param retryAfterMs the Retry-After of the response, 0 if there was none
+     * @return int the HTTP status code, 0 if the server was not reachable
+     */
+    virtual int write(const char *records, uint32_t *retryAfterMs) = 0;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @brief Temperature Ring Buffer
+ * @details This Programm is used to pass fixed size records between tasks without locks and without using the heap
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureRingBuffer_h
+#define TemperatureRingBuffer_h
+
+#include <atomic>
+#include <stddef.h>
+
+/**
+ * @brief Bounded lock-free queue, every task may push and pop at the same time
+ *
+ * @tparam T the record type, copied in and out
+ * @tparam N the capacity, has to be a power of two
+ */
+template <typename T, size_t N>
+class TemperatureRingBuffer
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "The capacity has to be a power of two");
+
+public:
+    TemperatureRingBuffer()
+    {
+        for (size_t i = 0; i < N; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+        pushPosition.store(0, std::memory_order_relaxed);
+        popPosition.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Add a record, never blocks
+     *
+     * @param value the record
+     * @return true if the record was added
+     * @return false if the buffer is full
+     */
+    bool push(const T &value)
+    {
+        size_t position = pushPosition.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;)
+        {
+            cell = &cells[position & (N - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            long difference = (long)sequence - (long)position;
+            if (difference == 0)
+            {
+                if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0) return false;
+            else position = pushPosition.load(std::memory_order_relaxed);
+        }
+        cell->data = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest record, never blocks
+     *
+     * @param value the record
+     * @return true if a record was taken
+     * @return false if the buffer is empty
+     */
+    bool pop(T &value)
+    {
+        size_t position = popPosition.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;)
+        {
+            cell = &cells[position & (N - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            long difference = (long)sequence - (long)(position + 1);
+            if (difference == 0)
+            {
+                if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0) return false;
+            else position = popPosition.load(std::memory_order_relaxed);
+        }
+        value = cell->data;
+        cell->sequence.store(position + N, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief The number of records, only a snapshot while other tasks are working on the buffer
+     */
+    size_t size() const
+    {
+        return pushPosition.load(std::memory_order_relaxed) - popPosition.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const { return size() == 0; }
+    size_t capacity() const { return N; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    Cell cells[N];
+    std::atomic<size_t> pushPosition;
+    std::atomic<size_t> popPosition;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "TemperatureScheduler.h"
+
+/**
+ * @brief Construct a new Temperature Scheduler
+ *
+ * @param samplePeriodMs the time between two samples, the samples are taken on multiples of it
+ * @param samplesPerUpload how many samples are combined to one upload
+ * @param uploadJitterMs the maximum delay of the upload, has to be smaller than samplePeriodMs
+ * @param lateToleranceMs how late a sample may be taken before its slot is skipped
+ * @param deviceSeed a unique number of the device, e.g. the MAC
+ */
+TemperatureScheduler::TemperatureScheduler(uint32_t samplePeriodMs, uint32_t samplesPerUpload, uint32_t uploadJitterMs, uint32_t lateToleranceMs, uint64_t deviceSeed)
+{
+    this->samplePeriodMs = samplePeriodMs > 0 ? samplePeriodMs : 1;
+    this->samplesPerUpload = samplesPerUpload > 0 ? samplesPerUpload : 1;
+    this->lateToleranceMs = lateToleranceMs;
+    this->synced = false;
+    this->lastSlot = -1;
+    this->lastSampleTime = -1;
+    this->skippedSlots = 0;
+
+    // Same jitter on every boot, but spread over the fleet
+    uint64_t hash = deviceSeed;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    uint32_t window = uploadJitterMs < this->samplePeriodMs ? uploadJitterMs : this->samplePeriodMs - 1;
+    this->uploadJitterMs = window > 0 ? hash % window : 0;
+}
+
+/**
+ * @brief Get the time to wait until the next sample
+ *
+ * @param now the wall clock in ms since 1970, or the uptime in ms if the time is not synced
+ * @return uint32_t the time to wait in ms
+ */
+uint32_t TemperatureScheduler::millisUntilSample(int64_t now)
+{
+    updateSynced(now);
+
+    if (!synced)
+    {
+        if (lastSampleTime < 0 || now - lastSampleTime >= samplePeriodMs) return 0;
+        return lastSampleTime + samplePeriodMs - now;
+    }
+
+    int64_t slot = now / samplePeriodMs;
+    if (slot <= lastSlot) slot = lastSlot + 1;
+    else if (now - slot * samplePeriodMs > lateToleranceMs) slot++;
+    return slot * samplePeriodMs > now ? slot * samplePeriodMs - now : 0;
+}
+
+/**
+ * @brief Register a sample, uses the same rule as millisUntilSample()
+ *
+ * @param now the wall clock in ms since 1970, or the uptime in ms if the time is not synced
+ * @return int64_t the slot of the sample, counts the samples if the time is not synced,
+ *         -1 if no slot is due, wait with millisUntilSample() and try again
+ */
+int64_t TemperatureScheduler::sample(int64_t now)
+{
+    updateSynced(now);
+
+    if (!synced)
+    {
+        lastSampleTime = now;
+        return ++lastSlot;
+    }
+
+    // An early wakeup is still in the slot which was sampled already
+    int64_t slot = now / samplePeriodMs;
+    if (slot <= lastSlot) return -1;
+
+    // Too late for this slot, it is skipped and counted with the next sample
+    if (now - slot * samplePeriodMs > lateToleranceMs) return -1;
+
+    if (lastSlot >= 0) skippedSlots += slot - lastSlot - 1;
+    lastSlot = slot;
+    lastSampleTime = now;
+    return slot;
+}
+
+/**
+ * @brief Check if a sample is the last one before an upload
+ *
+ * @param slot the slot of the sample
+ */
+bool TemperatureScheduler::isLastOfGroup(int64_t slot)
+{
+    return (slot + 1) % samplesPerUpload == 0;
+}
+
+/**
+ * @brief Get the upload group of a sample
+ *
+ * @param slot the slot of the sample
+ */
+int64_t TemperatureScheduler::getGroup(int64_t slot)
+{
+    return slot / samplesPerUpload;
+}
+
+/**
+ * @brief Get the start of an upload group
+ *
+ * @param group the upload group
+ * @return int64_t the wall clock in s since 1970, 0 if the time is not synced
+ */
+int64_t TemperatureScheduler::getGroupTime(int64_t group)
+{
+    if (!synced) return 0;
+    return group * samplesPerUpload * samplePeriodMs / 1000;
+}
+
+/**
+ * @brief Get the time to wait until the upload of a group
+ *
+ * @param now the wall clock in ms since 1970, or the uptime in ms if the time is not synced
+ * @param group the upload group
+ * @return uint32_t the time to wait in ms
+ */
+uint32_t TemperatureScheduler::millisUntilUpload(int64_t now, int64_t group)
+{
+    updateSynced(now);
+
+    int64_t uploadTime;
+    if (synced) uploadTime = (group + 1) * samplesPerUpload * samplePeriodMs - samplePeriodMs + uploadJitterMs;
+    else uploadTime = lastSampleTime + uploadJitterMs;
+
+    return uploadTime > now ? uploadTime - now : 0;
+}
+
+/**
+ * @brief Get the delay of the uploads of this device in ms
+ */
+uint32_t TemperatureScheduler::getUploadJitter()
+{
+    return uploadJitterMs;
+}
+
+/**
+ * @brief Get the number of slots in which no sample was taken
+ */
+uint32_t TemperatureScheduler::getSkippedSlots()
+{
+    return skippedSlots;
+}
+
+/**
+ * @brief Check if a time is a synced wall clock
+ *
+ * @param now the time in ms
+ */
+bool TemperatureScheduler::isSynced(int64_t now)
+{
+    return now >= SCHEDULER_SYNCED_AFTER_MS;
+}
+
+/**
+ * @brief Start counting the slots again if the clock was synced
+ *
+ * @param now the wall clock in ms since 1970, or the uptime in ms if the time is not synced
+ */
+void TemperatureScheduler::updateSynced(int64_t now)
+{
+    bool nowSynced = isSynced(now);
+    if (nowSynced == synced) return;
+
+    synced = nowSynced;
+    lastSlot = -1;
+    lastSampleTime = -1;
+}
@@ -0,0 +1,45 @@
+/**
+ * @brief Temperature Scheduler
+ * @details This Programm is used to align the samples and uploads to the wall clock
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureScheduler_h
+#define TemperatureScheduler_h
+
+#include <stdint.h>
+
+// Wall clock times before this (2020-09-13) mean the time was not synced yet
+#define SCHEDULER_SYNCED_AFTER_MS 1600000000000LL
+
+class TemperatureScheduler
+{
+public:
+    TemperatureScheduler(uint32_t samplePeriodMs, uint32_t samplesPerUpload, uint32_t uploadJitterMs, uint32_t lateToleranceMs, uint64_t deviceSeed);
+
+    uint32_t millisUntilSample(int64_t now);
+    int64_t sample(int64_t now);
+    bool isLastOfGroup(int64_t slot);
+    int64_t getGroup(int64_t slot);
+    int64_t getGroupTime(int64_t group);
+    uint32_t millisUntilUpload(int64_t now, int64_t group);
+    uint32_t getUploadJitter();
+    uint32_t getSkippedSlots();
+    bool isSynced(int64_t now);
+
+private:
+    void updateSynced(int64_t now);
+
+    uint32_t samplePeriodMs;
+    uint32_t samplesPerUpload;
+    uint32_t uploadJitterMs;
+    uint32_t lateToleranceMs;
+    bool synced;
+    int64_t lastSlot;
+    int64_t lastSampleTime;
+    uint32_t skippedSlots;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include "TemperatureTransmitter.h"
+
+#include <math.h>
+
+/**
+ * @brief Construct a new Temperature Transmitter
+ *
+ * @param scheduler the schedule of the samples and uploads
+ * @param uplink the queue of the points which are not written yet
+ * @param batchSize the maximum points per write request, at most TRANSMITTER_MAX_BATCH
+ * @param sendGuardMs the longest time a write can take, none is started this close to the next sample
+ * @param lineProtocol the encoder with the measurement and the tags
+ * @param clock the clock
+ * @param sensor the temperature sensor
+ * @param network the WiFi
+ * @param writer the writer for the InfluxDB
+ */
+TemperatureTransmitter::TemperatureTransmitter(TemperatureScheduler *scheduler, TemperatureUplink *uplink, uint32_t batchSize, uint32_t sendGuardMs,
+                                               TemperatureLineProtocol *lineProtocol, TemperatureClock *clock, TemperatureSensor *sensor,
+                                               TemperatureNetwork *network, TemperatureRecordWriter *writer)
+{
+    this->scheduler = scheduler;
+    this->uplink = uplink;
+    this->batchSize = batchSize < 1 ? 1 : (batchSize > TRANSMITTER_MAX_BATCH ? TRANSMITTER_MAX_BATCH : batchSize);
+    this->sendGuardMs = sendGuardMs;
+    this->lineProtocol = lineProtocol;
+    this->clock = clock;
+    this->sensor = sensor;
+    this->network = network;
+    this->writer = writer;
+    this->temperatureSum = 0;
+    this->temperatureCount = 0;
+    this->temperatureGroup = -1;
+    this->temperatureTime = 0;
+    this->uploadGroup = -1;
+    this->skippedSlots = 0;
+    this->wifiLost = false;
+    this->writes = 0;
+    this->failedWrites = 0;
+}
+
+/**
+ * @brief Queue the average and take the sample if they are due, then send the queued points
+ *
+ * @return uint32_t the time in ms until run() has to be called again
+ */
+uint32_t TemperatureTransmitter::run()
+{
+    int64_t now = getSchedulerTime();
+    if (uploadGroup >= 0 && scheduler->millisUntilUpload(now, uploadGroup) == 0) uploadTemperature();
+    if (scheduler->millisUntilSample(now) == 0) measureTemperature(now);
+    sendTemp();
+
+    now = getSchedulerTime();
+    uint32_t sampleWait = scheduler->millisUntilSample(now);
+    uint32_t wait = sampleWait;
+    if (uploadGroup >= 0)
+    {
+        uint32_t uploadWait = scheduler->millisUntilUpload(now, uploadGroup);
+        if (uploadWait < wait) wait = uploadWait;
+    }
+    uint32_t sendWait = millisUntilSend(sampleWait);
+    if (sendWait < wait) wait = sendWait;
+    return wait;
+}
+
+/**
+ * @brief Get the number of write requests
+ */
+uint32_t TemperatureTransmitter::getWrites()
+{
+    return writes;
+}
+
+/**
+ * @brief Get the number of write requests which were not answered with 2xx
+ */
+uint32_t TemperatureTransmitter::getFailedWrites()
+{
+    return failedWrites;
+}
+
+/**
+ * @brief Get the time for the scheduler
+ *
+ * @return int64_t the wall clock in ms since 1970 if it is synced, else the uptime in ms
+ */
+int64_t TemperatureTransmitter::getSchedulerTime()
+{
+    int64_t wallClock = clock->getWallClock();
+    return scheduler->isSynced(wallClock) ? wallClock : clock->getUptime();
+}
+
+/**
+ * @brief Take a sample in the due slot, the upload is planned after the last sample of a group
+ *
+ * @param now the time for the scheduler
+ */
+void TemperatureTransmitter::measureTemperature(int64_t now)
+{
+    int64_t slot = scheduler->sample(now);
+    if (slot < 0) return;
+    int64_t group = scheduler->getGroup(slot);
+
+    // Skipped slots or a time sync may have ended the last group early
+    if (group != temperatureGroup)
+    {
+        uploadTemperature();
+        temperatureGroup = group;
+        temperatureTime = scheduler->getGroupTime(group);
+    }
+
+    if (scheduler->getSkippedSlots() != skippedSlots)
+    {
+        skippedSlots = scheduler->getSkippedSlots();
+        logWarn(LOG_SENSOR, "Skipped slots", skippedSlots);
+    }
+
+    double temp = sensor->read();
+    if (isnan(temp))
+    {
+        logError(LOG_SENSOR, "No Sensor Connected");
+    }
+    else
+    {
+        logDebug(LOG_SENSOR, "Sample in °C", temp);
+        temperatureSum += temp;
+        temperatureCount++;
+    }
+
+    if (scheduler->isLastOfGroup(slot)) uploadGroup = group;
+}
+
+/**
+ * @brief Queue the average of the collected samples, it is sent by sendTemp()
+ */
+void TemperatureTransmitter::uploadTemperature()
+{
+    uploadGroup = -1;
+    if (temperatureCount == 0) return;
+
+    double average = temperatureSum / temperatureCount;
+    logInfo(LOG_SENSOR, "Measured Temperature in °C", average);
+    temperatureSum = 0;
+    temperatureCount = 0;
+    uplink->add({average, network->getRSSI(), (unsigned long)temperatureTime});
+}
+
+/**
+ * @brief Send the queued points to the InfluxDB, the newest first and older ones at a capped rate
+ */
+void TemperatureTransmitter::sendTemp()
+{
+    if (!network->hasWifi())
+    {
+        // Never wait for the WiFi here, the points stay queued and no failure is counted
+        network->reconnect();
+        if (!wifiLost) logWarn(LOG_WIFI, "No Wifi Connection");
+        wifiLost = true;
+        return;
+    }
+    wifiLost = false;
+
+    TemperatureUplinkPoint points[TRANSMITTER_MAX_BATCH];
+    size_t count;
+    while (scheduler->millisUntilSample(getSchedulerTime()) > sendGuardMs && (count = uplink->next(clock->getUptime(), points, batchSize)) > 0)
+    {
+        records.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (i > 0) records.append("\n");
+            records.append(lineProtocol->encode(points[i].temperature, points[i].rssi, points[i].time));
+        }
+
+        logDebug(LOG_INFLUX, "Writing", records.c_str());
+        writes++;
+        uint32_t retryAfterMs;
+        int status = writer->write(records.c_str(), &retryAfterMs);
+
+        // The backoff starts after the write, which may have taken up to the write timeout
+        uplink->result(clock->getUptime(), status, retryAfterMs);
+        if (status < 200 || status >= 300)
+        {
+            failedWrites++;
+            logError(LOG_INFLUX, "InfluxDB write failed", status);
+            logInfo(LOG_INFLUX, "Points waiting", (unsigned long)uplink->getBacklogSize());
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Get the time until sendTemp() has something to do
+ *
+ * @param sampleWait the time until the next sample
+ * @return uint32_t the time in ms, UPLINK_IDLE if nothing is queued or the write would run into the next sample
+ */
+uint32_t TemperatureTransmitter::millisUntilSend(uint32_t sampleWait)
+{
+    uint32_t wait = uplink->millisUntilNext(clock->getUptime());
+    if (wait == UPLINK_IDLE) return UPLINK_IDLE;
+
+    // The reconnect does not block, so it is tried again soon
+    if (!network->hasWifi()) return TRANSMITTER_WIFI_POLL_MS;
+
+    // Writes which would end after the next sample continue after it
+    if (wait + sendGuardMs >= sampleWait) return UPLINK_IDLE;
+    return wait;
+}
@@ -0,0 +1,117 @@
+/**
+ * @brief Temperature Transmitter
+ * @details This Programm is used to measure the Temperature on the schedule and send the averages to the InfluxDB
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureTransmitter_h
+#define TemperatureTransmitter_h
+
+#include <Arduino.h>
+#include "TemperatureLineProtocol.h"
+#include "TemperatureLogger.h"
+#include "TemperatureRecordWriter.h"
+#include "TemperatureScheduler.h"
+#include "TemperatureUplink.h"
+
+// Points per write request, a batch is one request with one record per line
+#define TRANSMITTER_MAX_BATCH 8
+
+// How often run() tries to reconnect while points wait for the WiFi
+#define TRANSMITTER_WIFI_POLL_MS 1000
+
+/**
+ * @brief The time of the device
+ */
+class TemperatureClock
+{
+public:
+    virtual ~TemperatureClock() {}
+
+    /**
+     * @brief Get the uptime, does not overflow like millis()
+     *
+     * @return int64_t the uptime in ms
+     */
+    virtual int64_t getUptime() = 0;
+
+    /**
+     * @brief Get the wall clock
+     *
+     * @return int64_t the time in ms since 1970, before SCHEDULER_SYNCED_AFTER_MS if it is not synced yet
+     */
+    virtual int64_t getWallClock() = 0;
+};
+
+/**
+ * @brief The temperature sensor
+ */
+class TemperatureSensor
+{
+public:
+    virtual ~TemperatureSensor() {}
+
+    /**
+     * @brief Take one sample
+     *
+     * @return double the temperature in °C, NAN if no sensor is connected
+     */
+    virtual double read() = 0;
+};
+
+/**
+ * @brief The WiFi of the device
+ */
+class TemperatureNetwork
+{
+public:
+    virtual ~TemperatureNetwork() {}
+
+    virtual bool hasWifi() = 0;
+    virtual void reconnect() = 0;
+    virtual long getRSSI() = 0;
+};
+
+class TemperatureTransmitter
+{
+public:
+    TemperatureTransmitter(TemperatureScheduler *scheduler, TemperatureUplink *uplink, uint32_t batchSize, uint32_t sendGuardMs,
+                           TemperatureLineProtocol *lineProtocol, TemperatureClock *clock, TemperatureSensor *sensor,
+                           TemperatureNetwork *network, TemperatureRecordWriter *writer);
+
+    uint32_t run();
+    uint32_t getWrites();
+    uint32_t getFailedWrites();
+
+private:
+    int64_t getSchedulerTime();
+    void measureTemperature(int64_t now);
+    void uploadTemperature();
+    void sendTemp();
+    uint32_t millisUntilSend(uint32_t sampleWait);
+
+    TemperatureScheduler *scheduler;
+    TemperatureUplink *uplink;
+    uint32_t batchSize;
+    uint32_t sendGuardMs;
+    TemperatureLineProtocol *lineProtocol;
+    TemperatureClock *clock;
+    TemperatureSensor *sensor;
+    TemperatureNetwork *network;
+    TemperatureRecordWriter *writer;
+
+    double temperatureSum;
+    int temperatureCount;
+    int64_t temperatureGroup;
+    int64_t temperatureTime;
+    int64_t uploadGroup;
+    uint32_t skippedSlots;
+    TemperatureFixedString<TRANSMITTER_MAX_BATCH *(LINE_PROTOCOL_MAX_LENGTH + 1)> records;
+    bool wifiLost;
+    uint32_t writes;
+    uint32_t failedWrites;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include "TemperatureUplink.h"
+
+/**
+ * @brief Construct a new Temperature Uplink
+ *
+ * @param initialBackoffMs the wait time after the first failed write
+ * @param maxBackoffMs the maximum wait time after failed writes
+ * @param backfillIntervalMs the minimum time between two points from the backlog
+ * @param seed a unique number of the device for the jitter, e.g. the MAC
+ */
+TemperatureUplink::TemperatureUplink(uint32_t initialBackoffMs, uint32_t maxBackoffMs, uint32_t backfillIntervalMs, uint64_t seed)
+{
+    this->initialBackoffMs = initialBackoffMs > 0 ? initialBackoffMs : 1;
+    this->maxBackoffMs = maxBackoffMs > this->initialBackoffMs ? maxBackoffMs : this->initialBackoffMs;
+    this->backfillIntervalMs = backfillIntervalMs;
+    this->hasFresh = false;
+    this->backlogStart = 0;
+    this->backlogCount = 0;
+    this->freshInFlight = false;
+    this->backlogInFlight = 0;
+    this->nextAttempt = 0;
+    this->nextBackfill = 0;
+    this->failures = 0;
+    this->droppedPoints = 0;
+    this->rejectedPoints = 0;
+    this->randomState = seed != 0 ? seed : 0x9e3779b97f4a7c15ULL;
+}
+
+/**
+ * @brief Queue a new point, it is sent before all older points
+ *
+ * @param point the point
+ */
+void TemperatureUplink::add(const TemperatureUplinkPoint &point)
+{
+    if (hasFresh) pushBacklog(fresh);
+    fresh = point;
+    hasFresh = true;
+}
+
+/**
+ * @brief Get the points to send now, result() has to be called before the next call
+ *
+ * @param now the time in ms
+ * @param points the buffer for the points
+ * @param maxPoints the size of the buffer
+ * @return size_t the number of points to send, 0 if nothing is due
+ */
+size_t TemperatureUplink::next(int64_t now, TemperatureUplinkPoint *points, size_t maxPoints)
+{
+    if (now < nextAttempt) return 0;
+
+    size_t count = 0;
+    if (hasFresh && count < maxPoints)
+    {
+        points[count++] = fresh;
+        freshInFlight = true;
+    }
+
+    // Older points only at the backfill rate, so a recovering fleet does not flood the server
+    if (now >= nextBackfill)
+    {
+        while (count < maxPoints && backlogInFlight < backlogCount)
+        {
+            points[count++] = backlog[(backlogStart + backlogInFlight) % UPLINK_BACKLOG_SIZE];
+            backlogInFlight++;
+        }
+        if (backlogInFlight > 0) nextBackfill = now + (int64_t)backlogInFlight * backfillIntervalMs;
+    }
+    return count;
+}
+
+/**
+ * @brief Report the result of the write of the points from next(), the points are kept and
+ * retried with a backoff unless they were written or rejected with 400, 413 or 422
+ *
+ * @param now the time in ms
+ * @param statusCode the HTTP status code, 0 if the server was not reachable
+ * @param retryAfterMs the Retry-After of the response, 0 if there was none
+ */
+void TemperatureUplink::result(int64_t now, int statusCode, uint32_t retryAfterMs)
+{
+    size_t sent = (freshInFlight ? 1 : 0) + backlogInFlight;
+    bool success = statusCode >= 200 && statusCode < 300;
+
+    // Only malformed or too large points would be rejected again, e.g. a wrong token (401),
+    // a missing bucket (404) or a proxy error keep the points until the server is fixed
+    bool rejected = statusCode == 400 || statusCode == 413 || statusCode == 422;
+
+    if (success || rejected)
+    {
+        if (rejected) rejectedPoints += sent;
+        if (freshInFlight) hasFresh = false;
+        popBacklog(backlogInFlight);
+        failures = 0;
+        nextAttempt = now;
+    }
+    else
+    {
+        failures++;
+        uint32_t wait = getBackoff();
+        if (statusCode == 429 || statusCode == 503)
+        {
+            uint32_t serverWait = retryAfterMs > 0 ? retryAfterMs : UPLINK_RETRY_AFTER_DEFAULT_MS;
+            if (serverWait > wait) wait = serverWait;
+        }
+        nextAttempt = now + wait;
+
+        // The next new point goes first, this one is sent with the backlog
+        if (freshInFlight)
+        {
+            hasFresh = false;
+            pushBacklog(fresh);
+        }
+    }
+
+    freshInFlight = false;
+    backlogInFlight = 0;
+}
+
+/**
+ * @brief Get the time until next() returns points
+ *
+ * @param now the time in ms
+ * @return uint32_t the time in ms, UPLINK_IDLE if nothing is queued
+ */
+uint32_t TemperatureUplink::millisUntilNext(int64_t now)
+{
+    if (!hasFresh && backlogCount == 0) return UPLINK_IDLE;
+
+    int64_t due = nextAttempt;
+    if (!hasFresh && nextBackfill > due) due = nextBackfill;
+    return due > now ? (uint32_t)(due - now) : 0;
+}
+
+/**
+ * @brief Get the number of older points which wait to be sent
+ */
+size_t TemperatureUplink::getBacklogSize()
+{
+    return backlogCount;
+}
+
+/**
+ * @brief Get the number of points which were dropped because the backlog was full
+ */
+uint32_t TemperatureUplink::getDroppedPoints()
+{
+    return droppedPoints;
+}
+
+/**
+ * @brief Get the number of points which the server rejected with 400, 413 or 422
+ */
+uint32_t TemperatureUplink::getRejectedPoints()
+{
+    return rejectedPoints;
+}
+
+/**
+ * @brief Get the number of failed writes since the last successful one
+ */
+uint32_t TemperatureUplink::getFailures()
+{
+    return failures;
+}
+
+/**
+ * @brief Add a point to the end of the backlog, the oldest point is dropped if it is full
+ *
+ * @param point the point
+ */
+void TemperatureUplink::pushBacklog(const TemperatureUplinkPoint &point)
+{
+    if (backlogCount == UPLINK_BACKLOG_SIZE)
+    {
+        popBacklog(1);
+        droppedPoints++;
+    }
+    backlog[(backlogStart + backlogCount) % UPLINK_BACKLOG_SIZE] = point;
+    backlogCount++;
+}
+
+/**
+ * @brief Remove the oldest points from the backlog
+ *
+ * @param count the number of points
+ */
+void TemperatureUplink::popBacklog(size_t count)
+{
+    if (count > backlogCount) count = backlogCount;
+    backlogStart = (backlogStart + count) % UPLINK_BACKLOG_SIZE;
+    backlogCount -= count;
+}
+
+/**
+ * @brief Get the exponential backoff with jitter, between half and the full backoff
+ */
+uint32_t TemperatureUplink::getBackoff()
+{
+    uint32_t backoff = initialBackoffMs;
+    for (uint32_t i = 1; i < failures && backoff < maxBackoffMs; i++) backoff *= 2;
+    if (backoff > maxBackoffMs) backoff = maxBackoffMs;
+
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    return backoff / 2 + (uint32_t)(randomState % (backoff / 2 + 1));
+}
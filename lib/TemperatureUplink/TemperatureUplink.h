@@ -0,0 +1,69 @@
+/**
+ * @brief Temperature Uplink
+ * @details This Programm is used to queue the points for the InfluxDB and to retry failed writes
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ */
+
+#ifndef TemperatureUplink_h
+#define TemperatureUplink_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Points which are kept while the InfluxDB can not be reached, the oldest are dropped first
+#define UPLINK_BACKLOG_SIZE 64
+
+// Wait time for 429 and 503 responses without a Retry-After header
+#define UPLINK_RETRY_AFTER_DEFAULT_MS 30000
+
+// Returned by millisUntilNext() if nothing is queued
+#define UPLINK_IDLE 0xFFFFFFFFUL
+
+struct TemperatureUplinkPoint
+{
+    double temperature;
+    long rssi;
+    unsigned long time;
+};
+
+class TemperatureUplink
+{
+public:
+    TemperatureUplink(uint32_t initialBackoffMs, uint32_t maxBackoffMs, uint32_t backfillIntervalMs, uint64_t seed);
+
+    void add(const TemperatureUplinkPoint &point);
+    size_t next(int64_t now, TemperatureUplinkPoint *points, size_t maxPoints);
+    void result(int64_t now, int statusCode, uint32_t retryAfterMs);
+    uint32_t millisUntilNext(int64_t now);
+    size_t getBacklogSize();
+    uint32_t getDroppedPoints();
+    uint32_t getRejectedPoints();
+    uint32_t getFailures();
+
+private:
+    void pushBacklog(const TemperatureUplinkPoint &point);
+    void popBacklog(size_t count);
+    uint32_t getBackoff();
+
+    TemperatureUplinkPoint fresh;
+    bool hasFresh;
+    TemperatureUplinkPoint backlog[UPLINK_BACKLOG_SIZE];
+    size_t backlogStart;
+    size_t backlogCount;
+    bool freshInFlight;
+    size_t backlogInFlight;
+
+    uint32_t initialBackoffMs;
+    uint32_t maxBackoffMs;
+    uint32_t backfillIntervalMs;
+    int64_t nextAttempt;
+    int64_t nextBackfill;
+    uint32_t failures;
+    uint32_t droppedPoints;
+    uint32_t rejectedPoints;
+    uint64_t randomState;
+};
+
+#endif
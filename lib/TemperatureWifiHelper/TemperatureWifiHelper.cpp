@@ -14,7 +14,7 @@ TemperatureWifiHelper::~TemperatureWifiHelper(){
  * 
  * @param ssid the ssid
  */
-void TemperatureWifiHelper::setSSID(String ssid)
+void TemperatureWifiHelper::setSSID(const char *ssid)
 {
     this->ssid = ssid;
 }
@@ -24,7 +24,7 @@ void TemperatureWifiHelper::setSSID(String ssid)
  * 
  * @param password the password
  */
-void TemperatureWifiHelper::setPassword(String password)
+void TemperatureWifiHelper::setPassword(const char *password)
 {
     this->password = password;
 }
@@ -37,21 +37,34 @@ void TemperatureWifiHelper::setPassword(String password)
  */
 bool TemperatureWifiHelper::connect()
 {
-    if (this->ssid != "")
+    if (!this->ssid.isEmpty())
     {
-        this->password == ""? WiFi.begin(this->ssid.c_str()) : WiFi.begin(this->ssid.c_str(), this->password.c_str());
+        this->password.isEmpty() ? WiFi.begin(this->ssid.c_str()) : WiFi.begin(this->ssid.c_str(), this->password.c_str());
 
-        printoutWifi("Connecting...\n");
+        logInfo(LOG_WIFI, "Connecting...");
 
         while (!WiFi.isConnected()) delay(500);
 
-        printoutWifi("WiFi connected\n");
-        printoutWifi("IP address: ");
-        Serial.println(WiFi.localIP());
+        logInfo(LOG_WIFI, "WiFi connected");
+        logInfo(LOG_WIFI, "IP address", WiFi.localIP().toString().c_str());
         return true;
     } else return false;
 }
 
+/**
+ * @brief Start a new connection attempt without waiting for it
+ */
+void TemperatureWifiHelper::reconnect()
+{
+    if (WiFi.isConnected() || this->ssid.isEmpty()) return;
+    if (lastReconnect != 0 && millis() - lastReconnect < WIFI_RECONNECT_INTERVAL_MS) return;
+
+    lastReconnect = millis();
+    logInfo(LOG_WIFI, "Reconnecting...");
+    WiFi.disconnect();
+    this->password.isEmpty() ? WiFi.begin(this->ssid.c_str()) : WiFi.begin(this->ssid.c_str(), this->password.c_str());
+}
+
 /**
  * @brief If the client is connected to the wifi
  * 
@@ -79,23 +92,21 @@ String *TemperatureWifiHelper::getWifiNetworksList()
 void TemperatureWifiHelper::discoverWifi()
 {
     WiFi.disconnect();
-    printoutWifi("Scanning for Wifi Networks...\n");
+    logInfo(LOG_WIFI, "Scanning for Wifi Networks...");
     int n = WiFi.scanNetworks();
     if (n == 0)
     {
-        printoutWifi("No networks found\n");
+        logWarn(LOG_WIFI, "No networks found");
     }
     else
     {
         this->wifiNetworksList = new String[n];
-        printoutWifi("Found " + String(n) + " networks:\n");
+        logInfo(LOG_WIFI, "Found networks", n);
         for (int i = 0; i < n; ++i)
         {
-            // Print SSID and RSSI for each network found
-            Serial.print(i + 1);
-            Serial.print(": ");
-            Serial.print(WiFi.SSID(i) + ", ");
+            // Print SSID for each network found
             this->wifiNetworksList[i] = WiFi.SSID(i);
+            logInfo(LOG_WIFI, "Network", this->wifiNetworksList[i].c_str());
             delay(10);
         }
     }
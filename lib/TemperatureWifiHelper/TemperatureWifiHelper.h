@@ -10,22 +10,26 @@
 #define TemperatureWifiHelper_h
 
 #include <Wifi.h>
+#include "TemperaturePreferences.h"
+#include "TemperatureLogger.h"
 
-#define printoutWifi(x) Serial.print("[WIFI] " + String(x));
+#define WIFI_RECONNECT_INTERVAL_MS 30000
 
 class TemperatureWifiHelper
 {
     public:
         ~TemperatureWifiHelper();
-        void setSSID(String ssid);
-        void setPassword(String password);
+        void setSSID(const char *ssid);
+        void setPassword(const char *password);
         bool connect();
+        void reconnect();
         bool hasWifi();
         String *getWifiNetworksList();
         void discoverWifi();
     private:
         String *wifiNetworksList;
-        String ssid;
-        String password;
+        WifiSsidString ssid;
+        WifiPasswordString password;
+        unsigned long lastReconnect = 0;
 };
 #endif
\ No newline at end of file
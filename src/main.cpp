@@ -29,10 +29,12 @@ DallasTemperature tempSensor(&oneWire);
 #define INFLUXDB_BUCKET "Test"
 
 // InfluxDB
-String influxdbUrl;
-String influxdbToken;
-String influxdbOrganisation;
-String influxdbBucket;
+InfluxUrlString influxdbUrl;
+InfluxTokenString influxdbToken;
+InfluxOrganisationString influxdbOrganisation;
+InfluxBucketString influxdbBucket;
+InfluxDBClient client;
+TemperatureInfluxWriter influxWriter(&client);
 
 // Preferences
 TemperaturePreferences settings("pref");
@@ -40,7 +42,75 @@ TemperatureWifiHelper wifi;
 TemperatureAccespoint accespoint(NODE_NAME);
 
 // Datapoints
-Point sensor(NODE_NAME);
+TemperatureLineProtocol sensor(NODE_NAME);
+
+// Schedule
+TemperatureScheduler scheduler(SAMPLE_PERIOD_MS, SAMPLES_PER_UPLOAD, UPLOAD_JITTER_MS, SAMPLE_LATE_TOLERANCE_MS, ESP.getEfuseMac());
+TemperatureUplink uplink(UPLINK_INITIAL_BACKOFF_MS, UPLINK_MAX_BACKOFF_MS, UPLINK_BACKFILL_INTERVAL_MS, ESP.getEfuseMac());
+
+// ------ DEVICE ------
+/**
+ * @brief The clock of the ESP32
+ */
+class DeviceClock : public TemperatureClock
+{
+public:
+    int64_t getUptime() override
+    {
+        return esp_timer_get_time() / 1000;
+    }
+
+    // Set by timeSync(), starts at 1970 after a reset
+    int64_t getWallClock() override
+    {
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        return (int64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+    }
+};
+
+/**
+ * @brief The DS18B20 on the OneWire bus
+ */
+class DeviceSensor : public TemperatureSensor
+{
+public:
+    double read() override
+    {
+        tempSensor.requestTemperatures();
+        double temp = tempSensor.getTempCByIndex(0);
+        return temp == DEVICE_DISCONNECTED_C ? NAN : temp;
+    }
+};
+
+/**
+ * @brief The WiFi of the ESP32
+ */
+class DeviceNetwork : public TemperatureNetwork
+{
+public:
+    bool hasWifi() override
+    {
+        return wifi.hasWifi();
+    }
+
+    // Starts a connection attempt at most every WIFI_RECONNECT_INTERVAL_MS and returns at once
+    void reconnect() override
+    {
+        wifi.reconnect();
+    }
+
+    long getRSSI() override
+    {
+        return WiFi.RSSI();
+    }
+};
+
+DeviceClock deviceClock;
+DeviceSensor deviceSensor;
+DeviceNetwork deviceNetwork;
+TemperatureTransmitter transmitter(&scheduler, &uplink, UPLOAD_BATCH_SIZE, UPLINK_SEND_GUARD_MS, &sensor,
+                                   &deviceClock, &deviceSensor, &deviceNetwork, &influxWriter);
 
 // ------ FUNCTIONS ------
 /**
@@ -55,86 +125,29 @@ String getHTMLString(bool addWifi, bool addInflux)
     {
         wifi.discoverWifi();
         wifiScanSSIDs = wifi.getWifiNetworksList();
-        Serial.println(sizeof(wifiScanSSIDs));
+        logDebug(LOG_WIFIAP, "Listed networks", sizeof(wifiScanSSIDs));
         for (int i = 0; i < sizeof(wifiScanSSIDs); i++)
         {
             html += String(i) + ") " + wifiScanSSIDs[i] + "<br>";
         }
         html += "SSID <input type=\"number\" name=\"ssid\" min = 0 max = ";
         html += String(sizeof(wifiScanSSIDs));
-        html += "><br>Password <input type=\"text\" name=\"passwd\"><br>";
+        html += "><br>Password <input type=\"text\" name=\"passwd\" maxlength=" + String(PREF_LENGTH_WIFI_PASSWORD) + "><br>";
     }
     if (addInflux)
     {
-        html += "InfluxDB URL <input type=\"text\" name=\"influxUrl\"><br>";
-        html += "InfluxDB Token <input type=\"text\" name=\"influxToken\"><br>";
-        html += "InfluxDB Organisation <input type=\"text\" name=\"influxOrganisation\"><br>";
-        html += "InfluxDB Bucket <input type=\"text\" name=\"influxBucket\"><br>";
+        html += "InfluxDB URL <input type=\"text\" name=\"influxUrl\" maxlength=" + String(PREF_LENGTH_INFLUX_URL) + "><br>";
+        html += "InfluxDB Token <input type=\"text\" name=\"influxToken\" maxlength=" + String(PREF_LENGTH_INFLUX_TOKEN) + "><br>";
+        html += "InfluxDB Organisation <input type=\"text\" name=\"influxOrganisation\" maxlength=" + String(PREF_LENGTH_INFLUX_ORGANISATION) + "><br>";
+        html += "InfluxDB Bucket <input type=\"text\" name=\"influxBucket\" maxlength=" + String(PREF_LENGTH_INFLUX_BUCKET) + "><br>";
     }
     html += "<input type=\"submit\" value=\"Submit\"></form><form actiom=\"/refresh\"><input type=\"submit\" value=\"Refresh\"></form></body></html>";
     return html;
 }
 
-/**
- * @brief Get the Temperature object
- *
- * @param temp the integer in witch the temperature should be stored
- * @param cycels how many cycles should be done to measure the temperature
- */
-double getTemperature(int cycels)
-{
-    double result = 1;
-    for (int i = 0; i < cycels; i++)
-    {
-        // Measuring
-        tempSensor.requestTemperatures();
-        result += tempSensor.getTempCByIndex(0);
-
-        if (isnan(tempSensor.getTempCByIndex(0)))
-        {
-            result = 0;
-            i = 0;
-            Serial.println("No Sensor Connected");
-        }
-        delay(60000); //One Minute
-    }
-    result = result / cycels;
-    Serial.println("Measured Temperature: " + String(result) + "°C" + " In " + String(cycels) + " Cycles");
-    return result;
-}
-
-/**
- * @brief send the Temperature to the InfluxDB
- *
- * @param temp the Temperature
- */
-void sendTemp(double *temp)
-{
-    // InfluxDB Client
-    InfluxDBClient client(influxdbUrl, influxdbOrganisation, influxdbBucket, influxdbToken, InfluxDbCloud2CACert);
-
-    sensor.clearFields();
-    //sensor.addField("rssi", WiFi.RSSI());
-    sensor.addField("temperature", temp);
-    sensor.addField("rssid", WiFi.RSSI());
-    Serial.print("Writing: ");
-
-    Serial.println(sensor.toLineProtocol());
-    if(!wifi.hasWifi()){
-        wifi.connect();
-        if(!wifi.hasWifi()) Serial.println("No Wifi Connection");
-    }
-    if (!client.writePoint(sensor))
-    {
-        Serial.print("InfluxDB write failed: ");
-        String errormessage = client.getLastErrorMessage();
-        Serial.println(errormessage);
-    }
-}
-
 void configureTemperatureSensor(int errorcode)
 {
-    Serial.println("No configuration found");
+    logInfo(LOG_CONF, "No configuration found");
 
     // Scan Wifi
     String webseiteStringHTML;
@@ -142,15 +155,15 @@ void configureTemperatureSensor(int errorcode)
     switch (errorcode)
     {
     case FAIL_MESSAGE_WIFI_CONNECT:
-        Serial.println("Failed last Time: WIFI");
+        logWarn(LOG_CONF, "Failed last Time: WIFI");
         webseiteStringHTML = getHTMLString(true, false);
         break;
     case INFLUX_PARAMETER_ERROR:
-        Serial.println("Failed last Time: INFLUX");
+        logWarn(LOG_CONF, "Failed last Time: INFLUX");
         webseiteStringHTML = getHTMLString(false, true);
         break;
     default:
-        Serial.println("Failed last Time: No Error given");
+        logInfo(LOG_CONF, "Failed last Time: No Error given");
         webseiteStringHTML = getHTMLString(true, true);
         break;
     }
@@ -162,34 +175,32 @@ void configureTemperatureSensor(int errorcode)
 
 void startTemperatureSensor()
 {
-    Serial.println("Configuration found:");
+    logInfo(LOG_CONF, "Configuration found");
 
     // Get Configuration from Preferences
-    String prefSSID;
-    String prefPasswd;
-    String perfInfluxUrl;
-    String perfInfluxPort;
-    String perfInfluxToken;
-    String perfInfluxOrganisation;
-    String perfInfluxBucket;
+    WifiSsidString prefSSID;
+    WifiPasswordString prefPasswd;
+    InfluxUrlString perfInfluxUrl;
+    InfluxTokenString perfInfluxToken;
+    InfluxOrganisationString perfInfluxOrganisation;
+    InfluxBucketString perfInfluxBucket;
 
     settings.getWiFiParameter(&prefSSID, &prefPasswd);
     settings.getInfluxParameter(&perfInfluxUrl, &perfInfluxToken, &perfInfluxOrganisation, &perfInfluxBucket);
 
-    printoutConfiguration("SSID: " + prefSSID + "\n");
-    printoutConfiguration("Password: ");
-    sizeof(prefPasswd) > 0 ? Serial.println("***********") : Serial.println("No Password");
-    printoutConfiguration("InfluxDB URL: " + perfInfluxUrl + "\n");
-    printoutConfiguration("InfluxDB Port: " + perfInfluxPort + "\n");
-    printoutConfiguration("InfluxDB Token: " + perfInfluxToken + "\n");
-    printoutConfiguration("InfluxDB Organisation: " + perfInfluxOrganisation + "\n");
-    printoutConfiguration("InfluxDB Bucket: " + perfInfluxBucket + "\n");
+    logInfo(LOG_CONF, "SSID", prefSSID.c_str());
+    logInfo(LOG_CONF, "Password", logSecret(prefPasswd.c_str()));
+    logInfo(LOG_CONF, "InfluxDB URL", perfInfluxUrl.c_str());
+    logInfo(LOG_CONF, "InfluxDB Token", logSecret(perfInfluxToken.c_str()));
+    logInfo(LOG_CONF, "InfluxDB Organisation", perfInfluxOrganisation.c_str());
+    logInfo(LOG_CONF, "InfluxDB Bucket", perfInfluxBucket.c_str());
 
     if (prefSSID == "No SSID" || prefPasswd == "No Password")
     {
-        printoutConfiguration("No SSID found\n");
+        logError(LOG_CONF, "No SSID found");
         settings.setErrorCode(FAIL_MESSAGE_WIFI_CONNECT);
         settings.setConfiguration(false);
+        logger.drain();
         ESP.restart();
     }
     else
@@ -200,9 +211,10 @@ void startTemperatureSensor()
 
     if (perfInfluxUrl == "No URL" || perfInfluxToken == "No Token" || perfInfluxOrganisation == "No Organisation" || perfInfluxBucket == "No Bucket")
     {
-        printoutConfiguration("Not all Parameter given\n");
+        logError(LOG_CONF, "Not all Parameter given");
         settings.setErrorCode(INFLUX_PARAMETER_ERROR);
         settings.setConfiguration(false);
+        logger.drain();
         ESP.restart();
     }
     else
@@ -218,43 +230,46 @@ void startTemperatureSensor()
 
     if (!wifi.hasWifi())
     {
-        Serial.println("[WIFI] Wifi connection lost");
+        logError(LOG_WIFI, "Wifi connection lost");
         settings.setErrorCode(FAIL_MESSAGE_WIFI_CONNECT);
         settings.setConfiguration(false);
+        logger.drain();
         ESP.restart();
     }
     else
     {
-        Serial.println("[WIFI] Wifi connected");
+        logInfo(LOG_WIFI, "Wifi connected");
     }
 
-    // InfluxDB Client
-    InfluxDBClient client(influxdbUrl, influxdbOrganisation, influxdbBucket, influxdbToken, InfluxDbCloud2CACert);
+    // InfluxDB Client, created once to keep the heap from fragmenting
+    client.setConnectionParams(influxdbUrl.c_str(), influxdbOrganisation.c_str(), influxdbBucket.c_str(), influxdbToken.c_str(), InfluxDbCloud2CACert);
+    // The uplink retries, the client must neither retry nor buffer on its own
+    client.setWriteOptions(WriteOptions().writePrecision(WritePrecision::S).maxRetryAttempts(0));
+    client.setHTTPOptions(HTTPOptions().httpReadTimeout(UPLINK_WRITE_TIMEOUT_MS).connectionReuse(true));
 
     // InfluxDB Configuration Sernsor
     sensor.addTag("device", DEVICE);
 
     timeSync(TZ_INFO, "pool.ntp.org", "time.nis.gov");
+    logInfo(LOG_MAIN, "Upload jitter in ms", scheduler.getUploadJitter());
 
     if (client.validateConnection())
     {
-        Serial.print("Connected to InfluxDB: ");
-        Serial.println(client.getServerUrl());
+        logInfo(LOG_INFLUX, "Connected to InfluxDB", influxdbUrl.c_str());
     }
     else
     {
-        Serial.print("InfluxDB connection failed: ");
-        String cause = client.getLastErrorMessage();
-        Serial.println(cause);
+        logError(LOG_INFLUX, "InfluxDB connection failed", client.getLastErrorMessage().c_str());
 
-        if (cause.equals("Invalid parameters"))
+        if (client.getLastErrorMessage().equals("Invalid parameters"))
         {
             settings.setErrorCode(INFLUX_PARAMETER_ERROR);
             settings.setConfiguration(false);
+            logger.drain();
             ESP.restart();
         }
         else
-            Serial.println("No known error");
+            logWarn(LOG_INFLUX, "No known error");
     }
 }
 
@@ -267,7 +282,8 @@ void setup()
     // Serial
     Serial.begin(115200);
     delay(1);
-    Serial.println("Starting...");
+    logger.begin();
+    logInfo(LOG_MAIN, "Starting...");
 
     // Pins
     pinMode(LED_BUILTIN, OUTPUT);
@@ -276,7 +292,7 @@ void setup()
 
     if (digitalRead(RESET_BUTTON_PIN) == HIGH)
     {
-        Serial.println("Reset button pressed");
+        logInfo(LOG_MAIN, "Reset button pressed");
         settings.setConfiguration(false);
         delay(5000);
         ESP.restart();
@@ -297,9 +313,6 @@ void setup()
  */
 void loop()
 {
-    if (settings.hasConfiguration())
-    {
-        double temp = getTemperature(10);
-        sendTemp(&temp);
-    } else accespoint.handle();
+    if (settings.hasConfiguration()) delay(transmitter.run());
+    else accespoint.handle();
 }
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ * @brief Temperature Scheduler Test
+ * @details This Programm is used to test the TemperatureScheduler with a fake clock
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Run: pio test -e native -f test_scheduler
+ */
+
+#include <unity.h>
+#include "TemperatureScheduler.h"
+
+#define TEST_PERIOD_MS 60000
+#define TEST_SAMPLES_PER_UPLOAD 10
+#define TEST_JITTER_MS 30000
+#define TEST_TOLERANCE_MS 2000
+#define TEST_SEED 0x24a160123456ULL
+
+// 2023-11-14 22:14:00 UTC, a multiple of the period
+#define TEST_START_MS 1700000040000LL
+
+/**
+ * @brief The wall clock, the scheduler only sees the time which is passed to it
+ */
+class FakeClock
+{
+public:
+    int64_t now = TEST_START_MS;
+    uint64_t state = 1;
+
+    /**
+     * @brief Sleep like delay(), which may wake up late
+     *
+     * @param waitMs the requested time
+     * @param maxLateMs the maximum additional time
+     */
+    void sleep(uint32_t waitMs, uint32_t maxLateMs)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        now += waitMs + (maxLateMs > 0 ? (state >> 33) % (maxLateMs + 1) : 0);
+    }
+};
+
+static TemperatureScheduler createScheduler(uint64_t seed = TEST_SEED)
+{
+    return TemperatureScheduler(TEST_PERIOD_MS, TEST_SAMPLES_PER_UPLOAD, TEST_JITTER_MS, TEST_TOLERANCE_MS, seed);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_waits_for_the_next_slot()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t now = TEST_START_MS + 12345;
+
+    TEST_ASSERT_EQUAL_UINT32(TEST_PERIOD_MS - 12345, scheduler.millisUntilSample(now));
+    TEST_ASSERT_EQUAL_INT64(-1, scheduler.sample(now));
+
+    now += scheduler.millisUntilSample(now);
+    TEST_ASSERT_EQUAL_INT64(now / TEST_PERIOD_MS, scheduler.sample(now));
+    TEST_ASSERT_EQUAL_UINT32(TEST_PERIOD_MS, scheduler.millisUntilSample(now));
+}
+
+void test_early_wakeup_waits_again()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t slot = scheduler.sample(TEST_START_MS);
+    TEST_ASSERT_EQUAL_INT64(TEST_START_MS / TEST_PERIOD_MS, slot);
+
+    int64_t early = TEST_START_MS + TEST_PERIOD_MS - 5;
+    TEST_ASSERT_EQUAL_INT64(-1, scheduler.sample(early));
+    TEST_ASSERT_EQUAL_UINT32(5, scheduler.millisUntilSample(early));
+    TEST_ASSERT_EQUAL_INT64(slot + 1, scheduler.sample(early + 5));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getSkippedSlots());
+}
+
+void test_late_wakeup_within_tolerance()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t slot = scheduler.sample(TEST_START_MS);
+    int64_t late = TEST_START_MS + TEST_PERIOD_MS + TEST_TOLERANCE_MS;
+
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.millisUntilSample(late));
+    TEST_ASSERT_EQUAL_INT64(slot + 1, scheduler.sample(late));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getSkippedSlots());
+}
+
+void test_late_wakeup_skips_the_slot()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t slot = scheduler.sample(TEST_START_MS);
+    int64_t late = TEST_START_MS + TEST_PERIOD_MS + TEST_TOLERANCE_MS + 1;
+
+    TEST_ASSERT_EQUAL_INT64(-1, scheduler.sample(late));
+    TEST_ASSERT_EQUAL_UINT32(TEST_PERIOD_MS - TEST_TOLERANCE_MS - 1, scheduler.millisUntilSample(late));
+
+    int64_t next = TEST_START_MS + 2 * TEST_PERIOD_MS;
+    TEST_ASSERT_EQUAL_INT64(slot + 2, scheduler.sample(next));
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getSkippedSlots());
+}
+
+void test_clock_jump_counts_skipped_slots()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t slot = scheduler.sample(TEST_START_MS);
+
+    // e.g. a blocking reconnect or an SNTP correction
+    int64_t jumped = TEST_START_MS + 10 * TEST_PERIOD_MS + 500;
+    TEST_ASSERT_EQUAL_INT64(slot + 10, scheduler.sample(jumped));
+    TEST_ASSERT_EQUAL_UINT32(9, scheduler.getSkippedSlots());
+}
+
+void test_drift_stays_on_the_slots()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    FakeClock clock;
+    clock.now += 777;
+
+    int64_t firstSlot = -1;
+    int64_t lastSlot = -1;
+    uint32_t samples = 0;
+    for (int i = 0; i < 20000; i++)
+    {
+        // Every wakeup is up to 2.5 s late, some of them beyond the tolerance
+        clock.sleep(scheduler.millisUntilSample(clock.now), TEST_TOLERANCE_MS + 500);
+        int64_t slot = scheduler.sample(clock.now);
+        if (slot < 0) continue;
+
+        TEST_ASSERT_EQUAL_INT64(clock.now / TEST_PERIOD_MS, slot);
+        TEST_ASSERT_TRUE(clock.now - slot * TEST_PERIOD_MS <= TEST_TOLERANCE_MS);
+        TEST_ASSERT_TRUE(slot > lastSlot);
+        if (firstSlot < 0) firstSlot = slot;
+        lastSlot = slot;
+        samples++;
+    }
+
+    TEST_ASSERT_TRUE(scheduler.getSkippedSlots() > 0);
+    TEST_ASSERT_EQUAL_INT64(lastSlot - firstSlot + 1, (int64_t)samples + scheduler.getSkippedSlots());
+}
+
+void test_groups_and_upload_time()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t groupLengthMs = (int64_t)TEST_PERIOD_MS * TEST_SAMPLES_PER_UPLOAD;
+    int64_t groupStart = (TEST_START_MS / groupLengthMs + 1) * groupLengthMs;
+    int64_t lastSlotStart = groupStart + groupLengthMs - TEST_PERIOD_MS;
+
+    int64_t first = scheduler.sample(groupStart);
+    int64_t last = scheduler.sample(lastSlotStart);
+    TEST_ASSERT_FALSE(scheduler.isLastOfGroup(first));
+    TEST_ASSERT_TRUE(scheduler.isLastOfGroup(last));
+    TEST_ASSERT_EQUAL_INT64(scheduler.getGroup(first), scheduler.getGroup(last));
+    TEST_ASSERT_EQUAL_INT64(groupStart / 1000, scheduler.getGroupTime(scheduler.getGroup(first)));
+    TEST_ASSERT_EQUAL_UINT32(scheduler.getUploadJitter(), scheduler.millisUntilUpload(lastSlotStart, scheduler.getGroup(last)));
+}
+
+void test_upload_jitter_is_fixed_per_device()
+{
+    TEST_ASSERT_EQUAL_UINT32(createScheduler().getUploadJitter(), createScheduler().getUploadJitter());
+
+    uint32_t minimum = TEST_JITTER_MS;
+    uint32_t maximum = 0;
+    for (uint64_t seed = 1; seed <= 1000; seed++)
+    {
+        uint32_t jitter = createScheduler(seed).getUploadJitter();
+        TEST_ASSERT_TRUE(jitter < TEST_JITTER_MS);
+        if (jitter < minimum) minimum = jitter;
+        if (jitter > maximum) maximum = jitter;
+    }
+
+    // Consecutive MACs are spread over the whole window
+    TEST_ASSERT_TRUE(minimum < TEST_JITTER_MS / 10);
+    TEST_ASSERT_TRUE(maximum > TEST_JITTER_MS * 9 / 10);
+}
+
+void test_unsynced_clock_uses_the_uptime()
+{
+    TemperatureScheduler scheduler = createScheduler();
+    int64_t uptime = 3000;
+
+    TEST_ASSERT_FALSE(scheduler.isSynced(uptime));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.millisUntilSample(uptime));
+    TEST_ASSERT_EQUAL_INT64(0, scheduler.sample(uptime));
+    TEST_ASSERT_EQUAL_INT64(0, scheduler.getGroupTime(0));
+    TEST_ASSERT_EQUAL_UINT32(TEST_PERIOD_MS, scheduler.millisUntilSample(uptime));
+    TEST_ASSERT_EQUAL_INT64(1, scheduler.sample(uptime + TEST_PERIOD_MS));
+
+    // After the sync the slots follow the wall clock
+    TEST_ASSERT_EQUAL_INT64(TEST_START_MS / TEST_PERIOD_MS, scheduler.sample(TEST_START_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getSkippedSlots());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_waits_for_the_next_slot);
+    RUN_TEST(test_early_wakeup_waits_again);
+    RUN_TEST(test_late_wakeup_within_tolerance);
+    RUN_TEST(test_late_wakeup_skips_the_slot);
+    RUN_TEST(test_clock_jump_counts_skipped_slots);
+    RUN_TEST(test_drift_stays_on_the_slots);
+    RUN_TEST(test_groups_and_upload_time);
+    RUN_TEST(test_upload_jitter_is_fixed_per_device);
+    RUN_TEST(test_unsynced_clock_uses_the_uptime);
+    return UNITY_END();
+}
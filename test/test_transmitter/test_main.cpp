@@ -0,0 +1,230 @@
+/**
+ * @brief Temperature Transmitter Test
+ * @details This Programm is used to test the TemperatureTransmitter with a fake clock, WiFi and InfluxDB
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Run: pio test -e native -f test_transmitter
+ */
+
+#include <unity.h>
+#include "TemperatureTransmitter.h"
+
+#define TEST_PERIOD_MS 60000
+#define TEST_SAMPLES_PER_UPLOAD 10
+#define TEST_JITTER_MS 30000
+#define TEST_TOLERANCE_MS 2000
+#define TEST_INITIAL_BACKOFF_MS 5000
+#define TEST_MAX_BACKOFF_MS 300000
+#define TEST_BACKFILL_INTERVAL_MS 5000
+#define TEST_SEND_GUARD_MS 15000
+#define TEST_BATCH_SIZE 4
+#define TEST_SEED 0x24a160123456ULL
+#define TEST_MAX_WRITES 1024
+
+// 2023-11-14 22:10:00 UTC, the start of an upload group
+#define TEST_START_MS 1700000000000LL
+#define TEST_GROUP_MS ((int64_t)TEST_PERIOD_MS * TEST_SAMPLES_PER_UPLOAD)
+
+class FakeClock : public TemperatureClock
+{
+public:
+    int64_t now = TEST_START_MS;
+
+    int64_t getUptime() override { return now - TEST_START_MS; }
+    int64_t getWallClock() override { return now; }
+};
+
+class FakeSensor : public TemperatureSensor
+{
+public:
+    double read() override { return 21.5; }
+};
+
+class FakeNetwork : public TemperatureNetwork
+{
+public:
+    bool wifi = true;
+    int reconnects = 0;
+
+    bool hasWifi() override { return wifi; }
+    void reconnect() override { reconnects++; }
+    long getRSSI() override { return -60; }
+};
+
+/**
+ * @brief InfluxDB stub, answers with the queued status codes and moves the fake clock by its latency
+ */
+class StubWriter : public TemperatureRecordWriter
+{
+public:
+    FakeClock *clock;
+    uint32_t latencyMs = 0;
+    int statusCode = 204;
+    int failures = 0;
+    uint32_t retryAfterMs = 0;
+    int64_t startTimes[TEST_MAX_WRITES];
+    int64_t endTimes[TEST_MAX_WRITES];
+    int writes = 0;
+    int points = 0;
+
+    explicit StubWriter(FakeClock *clock) : clock(clock) {}
+
+    /**
+     * @brief Answer the next writes with a status code, afterwards with 204
+     *
+     * @param code the status code, 0 for an unreachable server
+     * @param count the number of writes
+     */
+    void fail(int code, int count)
+    {
+        statusCode = code;
+        failures = count;
+    }
+
+    int write(const char *records, uint32_t *retryAfterMs) override
+    {
+        if (writes < TEST_MAX_WRITES) startTimes[writes] = clock->now;
+        clock->now += latencyMs;
+        if (writes < TEST_MAX_WRITES) endTimes[writes] = clock->now;
+        writes++;
+
+        *retryAfterMs = 0;
+        if (failures > 0)
+        {
+            failures--;
+            *retryAfterMs = this->retryAfterMs;
+            return statusCode;
+        }
+        points++;
+        for (const char *c = records; *c != '\0'; c++)
+            if (*c == '\n') points++;
+        return 204;
+    }
+};
+
+/**
+ * @brief One transmitter with its fakes, driven like loop() in main.cpp
+ */
+class TestDevice
+{
+public:
+    FakeClock clock;
+    FakeSensor sensor;
+    FakeNetwork network;
+    StubWriter writer;
+    TemperatureScheduler scheduler;
+    TemperatureUplink uplink;
+    TemperatureLineProtocol lineProtocol;
+    TemperatureTransmitter transmitter;
+    int runs = 0;
+
+    TestDevice()
+        : writer(&clock),
+          scheduler(TEST_PERIOD_MS, TEST_SAMPLES_PER_UPLOAD, TEST_JITTER_MS, TEST_TOLERANCE_MS, TEST_SEED),
+          uplink(TEST_INITIAL_BACKOFF_MS, TEST_MAX_BACKOFF_MS, TEST_BACKFILL_INTERVAL_MS, TEST_SEED),
+          lineProtocol("TemperatureWifi"),
+          transmitter(&scheduler, &uplink, TEST_BATCH_SIZE, TEST_SEND_GUARD_MS, &lineProtocol, &clock, &sensor, &network, &writer)
+    {
+    }
+
+    /**
+     * @brief Run until the clock reached the end
+     *
+     * @param end the wall clock in ms
+     * @return uint32_t the longest wait which run() returned
+     */
+    uint32_t runUntil(int64_t end)
+    {
+        uint32_t longest = 0;
+        while (clock.now < end)
+        {
+            uint32_t wait = transmitter.run();
+            if (wait > longest) longest = wait;
+            clock.now += wait;
+            runs++;
+        }
+        return longest;
+    }
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_sends_one_point_per_group()
+{
+    TestDevice device;
+    device.runUntil(TEST_START_MS + 3 * TEST_GROUP_MS + TEST_JITTER_MS);
+
+    TEST_ASSERT_EQUAL_INT(3, device.writer.writes);
+    TEST_ASSERT_EQUAL_INT(3, device.writer.points);
+    TEST_ASSERT_EQUAL_UINT32(0, device.transmitter.getFailedWrites());
+    TEST_ASSERT_EQUAL_INT(0, device.network.reconnects);
+}
+
+void test_no_wifi_is_not_a_failure()
+{
+    TestDevice device;
+    device.network.wifi = false;
+    uint32_t longest = device.runUntil(TEST_START_MS + 3 * TEST_GROUP_MS);
+
+    // The points wait in the uplink without a backoff, every run tries to reconnect
+    TEST_ASSERT_EQUAL_INT(0, device.writer.writes);
+    TEST_ASSERT_EQUAL_UINT32(0, device.uplink.getFailures());
+    TEST_ASSERT_EQUAL_INT(device.runs, device.network.reconnects);
+    TEST_ASSERT_TRUE(device.runs > 3 * TEST_SAMPLES_PER_UPLOAD);
+    TEST_ASSERT_TRUE(longest <= TEST_PERIOD_MS);
+
+    // The points are sent within one poll after the WiFi is back, the backlog in one batch
+    device.network.wifi = true;
+    int64_t back = device.clock.now;
+    device.runUntil(back + TRANSMITTER_WIFI_POLL_MS + 1);
+    TEST_ASSERT_EQUAL_INT(1, device.writer.writes);
+    TEST_ASSERT_EQUAL_INT(3, device.writer.points);
+    TEST_ASSERT_TRUE(device.writer.startTimes[0] - back <= TRANSMITTER_WIFI_POLL_MS);
+}
+
+void test_no_write_inside_the_guard()
+{
+    TestDevice device;
+    device.writer.latencyMs = 4000;
+    device.writer.fail(503, 40);
+    device.writer.retryAfterMs = 7000;
+    device.runUntil(TEST_START_MS + 100 * TEST_GROUP_MS);
+
+    TEST_ASSERT_TRUE(device.writer.writes > 50);
+    for (int i = 0; i < device.writer.writes && i < TEST_MAX_WRITES; i++)
+    {
+        int64_t untilSample = TEST_PERIOD_MS - device.writer.startTimes[i] % TEST_PERIOD_MS;
+        TEST_ASSERT_TRUE(untilSample > TEST_SEND_GUARD_MS);
+    }
+
+    // The failures have not lost a point, the backlog is sent in batches
+    TEST_ASSERT_EQUAL_UINT32(0, device.scheduler.getSkippedSlots());
+    TEST_ASSERT_EQUAL_UINT32(0, device.uplink.getDroppedPoints());
+    TEST_ASSERT_EQUAL_INT(100, device.writer.points + (int)device.uplink.getBacklogSize());
+}
+
+void test_backoff_starts_after_the_write()
+{
+    TestDevice device;
+    device.writer.latencyMs = 4000;
+    device.writer.fail(0, 1);
+    device.runUntil(TEST_START_MS + TEST_GROUP_MS + TEST_JITTER_MS + TEST_INITIAL_BACKOFF_MS + 2 * device.writer.latencyMs);
+
+    TEST_ASSERT_EQUAL_INT(2, device.writer.writes);
+    TEST_ASSERT_EQUAL_UINT32(1, device.transmitter.getFailedWrites());
+    TEST_ASSERT_TRUE(device.writer.startTimes[1] - device.writer.endTimes[0] >= TEST_INITIAL_BACKOFF_MS / 2);
+    TEST_ASSERT_TRUE(device.writer.startTimes[1] - device.writer.endTimes[0] <= TEST_INITIAL_BACKOFF_MS);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sends_one_point_per_group);
+    RUN_TEST(test_no_wifi_is_not_a_failure);
+    RUN_TEST(test_no_write_inside_the_guard);
+    RUN_TEST(test_backoff_starts_after_the_write);
+    return UNITY_END();
+}
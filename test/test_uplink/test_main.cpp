@@ -0,0 +1,310 @@
+/**
+ * @brief Temperature Uplink Test
+ * @details This Programm is used to test the TemperatureUplink against a stub writer which injects status codes and latency
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Run: pio test -e native -f test_uplink
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unity.h>
+#include "TemperatureRecordWriter.h"
+#include "TemperatureUplink.h"
+
+#define TEST_INITIAL_BACKOFF_MS 5000
+#define TEST_MAX_BACKOFF_MS 300000
+#define TEST_BACKFILL_INTERVAL_MS 5000
+#define TEST_SEED 0x24a160123456ULL
+#define TEST_MAX_WRITES 256
+
+/**
+ * @brief InfluxDB stub, answers with the queued status codes and moves the fake clock by its latency
+ */
+class StubWriter : public TemperatureRecordWriter
+{
+public:
+    int64_t now = 0;
+    uint32_t latencyMs = 0;
+    int statusCode = 204;
+    int failures = 0;
+    unsigned long times[TEST_MAX_WRITES];
+    int64_t writeTimes[TEST_MAX_WRITES];
+    int writes = 0;
+
+    /**
+     * @brief Answer the next writes with a status code, afterwards with 204
+     *
+     * @param code the status code, 0 for an unreachable server
+     * @param count the number of writes
+     */
+    void fail(int code, int count)
+    {
+        statusCode = code;
+        failures = count;
+    }
+
+    int write(const char *record, uint32_t *retryAfterMs) override
+    {
+        now += latencyMs;
+        *retryAfterMs = 0;
+        int status = 204;
+        if (failures > 0)
+        {
+            failures--;
+            status = statusCode;
+        }
+        if (status >= 200 && status < 300 && writes < TEST_MAX_WRITES)
+        {
+            times[writes] = strtoul(record, nullptr, 10);
+            writeTimes[writes] = now;
+            writes++;
+        }
+        return status;
+    }
+};
+
+static TemperatureUplink createUplink()
+{
+    return TemperatureUplink(TEST_INITIAL_BACKOFF_MS, TEST_MAX_BACKOFF_MS, TEST_BACKFILL_INTERVAL_MS, TEST_SEED);
+}
+
+static TemperatureUplinkPoint point(unsigned long time)
+{
+    return {21.5, -60, time};
+}
+
+/**
+ * @brief Same as TemperatureTransmitter::sendTemp() with one point per write, the time of the point is the record
+ *
+ * @return int the status of the last write, 0 if nothing was due
+ */
+static int send(TemperatureUplink &uplink, StubWriter &writer, int retryAfterMs = 0)
+{
+    TemperatureUplinkPoint next;
+    int status = 0;
+    while (uplink.next(writer.now, &next, 1) > 0)
+    {
+        char record[24];
+        snprintf(record, sizeof(record), "%lu", next.time);
+        uint32_t stubRetryAfterMs;
+        status = writer.write(record, &stubRetryAfterMs);
+        uplink.result(writer.now, status, retryAfterMs);
+        if (status < 200 || status >= 300) break;
+    }
+    return status;
+}
+
+/**
+ * @brief Move the clock to the next due write and send
+ */
+static int sendNext(TemperatureUplink &uplink, StubWriter &writer, int retryAfterMs = 0)
+{
+    writer.now += uplink.millisUntilNext(writer.now);
+    return send(uplink, writer, retryAfterMs);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sends_a_point()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+
+    TEST_ASSERT_EQUAL_UINT32(UPLINK_IDLE, uplink.millisUntilNext(writer.now));
+    uplink.add(point(1000));
+    TEST_ASSERT_EQUAL_UINT32(0, uplink.millisUntilNext(writer.now));
+    TEST_ASSERT_EQUAL_INT(204, send(uplink, writer));
+    TEST_ASSERT_EQUAL_INT(1, writer.writes);
+    TEST_ASSERT_EQUAL_UINT32(1000, writer.times[0]);
+    TEST_ASSERT_EQUAL_UINT32(UPLINK_IDLE, uplink.millisUntilNext(writer.now));
+}
+
+void test_backoff_grows_until_the_cap()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+    writer.fail(0, 1000);
+    uplink.add(point(1000));
+
+    uint32_t backoff = TEST_INITIAL_BACKOFF_MS;
+    for (int failure = 1; failure <= 12; failure++)
+    {
+        TEST_ASSERT_EQUAL_INT(0, sendNext(uplink, writer));
+        TEST_ASSERT_EQUAL_UINT32(failure, uplink.getFailures());
+
+        // Equal jitter, between half and the full backoff
+        uint32_t wait = uplink.millisUntilNext(writer.now);
+        TEST_ASSERT_TRUE(wait >= backoff / 2);
+        TEST_ASSERT_TRUE(wait <= backoff);
+
+        backoff = backoff * 2 < TEST_MAX_BACKOFF_MS ? backoff * 2 : TEST_MAX_BACKOFF_MS;
+    }
+
+    // The first success resets the backoff
+    writer.fail(0, 0);
+    TEST_ASSERT_EQUAL_INT(204, sendNext(uplink, writer));
+    TEST_ASSERT_EQUAL_UINT32(0, uplink.getFailures());
+    TEST_ASSERT_EQUAL_UINT32(0, uplink.getDroppedPoints());
+}
+
+void test_backoff_starts_after_a_slow_write()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+    writer.latencyMs = 4000;
+    writer.fail(504, 1);
+    uplink.add(point(1000));
+
+    TEST_ASSERT_EQUAL_INT(504, send(uplink, writer));
+    TEST_ASSERT_EQUAL_INT64(4000, writer.now);
+    uint32_t wait = uplink.millisUntilNext(writer.now);
+    TEST_ASSERT_TRUE(wait >= TEST_INITIAL_BACKOFF_MS / 2);
+    TEST_ASSERT_TRUE(wait <= TEST_INITIAL_BACKOFF_MS);
+
+    TEST_ASSERT_EQUAL_INT(204, sendNext(uplink, writer));
+    TEST_ASSERT_EQUAL_INT64(4000 + wait + 4000, writer.writeTimes[0]);
+}
+
+void test_retry_after_is_a_floor()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+    uplink.add(point(1000));
+
+    writer.fail(503, 1);
+    TEST_ASSERT_EQUAL_INT(503, send(uplink, writer, 60000));
+    TEST_ASSERT_EQUAL_UINT32(60000, uplink.millisUntilNext(writer.now));
+
+    // Without a Retry-After the default is used
+    writer.fail(429, 1);
+    TEST_ASSERT_EQUAL_INT(429, sendNext(uplink, writer));
+    TEST_ASSERT_EQUAL_UINT32(UPLINK_RETRY_AFTER_DEFAULT_MS, uplink.millisUntilNext(writer.now));
+
+    // A shorter Retry-After does not shorten the backoff
+    for (int i = 0; i < 6; i++)
+    {
+        writer.fail(503, 1);
+        sendNext(uplink, writer, 1000);
+    }
+    TEST_ASSERT_TRUE(uplink.millisUntilNext(writer.now) >= TEST_INITIAL_BACKOFF_MS * 32 / 2);
+}
+
+void test_fresh_point_before_the_backlog()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+    writer.fail(0, 1000);
+
+    for (unsigned long time = 1; time <= 5; time++)
+    {
+        uplink.add(point(time));
+        sendNext(uplink, writer);
+    }
+    TEST_ASSERT_EQUAL_size_t(5, uplink.getBacklogSize());
+
+    writer.fail(0, 0);
+    uplink.add(point(6));
+    while (uplink.millisUntilNext(writer.now) != UPLINK_IDLE) sendNext(uplink, writer);
+
+    // The newest first, then the backlog from the oldest
+    unsigned long expected[] = {6, 1, 2, 3, 4, 5};
+    TEST_ASSERT_EQUAL_INT(6, writer.writes);
+    for (int i = 0; i < 6; i++) TEST_ASSERT_EQUAL_UINT32(expected[i], writer.times[i]);
+}
+
+void test_backfill_rate_is_capped()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+    writer.fail(0, 1000);
+
+    for (unsigned long time = 1; time <= 10; time++)
+    {
+        uplink.add(point(time));
+        sendNext(uplink, writer);
+    }
+
+    writer.fail(0, 0);
+    writer.now += TEST_MAX_BACKOFF_MS;
+    while (uplink.millisUntilNext(writer.now) != UPLINK_IDLE) sendNext(uplink, writer);
+
+    TEST_ASSERT_EQUAL_INT(10, writer.writes);
+    for (int i = 1; i < writer.writes; i++)
+        TEST_ASSERT_TRUE(writer.writeTimes[i] - writer.writeTimes[i - 1] >= TEST_BACKFILL_INTERVAL_MS);
+}
+
+void test_full_backlog_drops_the_oldest()
+{
+    TemperatureUplink uplink = createUplink();
+    StubWriter writer;
+
+    // Without WiFi nothing is sent, one point is fresh and the others wait in the backlog
+    int added = UPLINK_BACKLOG_SIZE + 4;
+    for (int time = 1; time <= added; time++) uplink.add(point(time));
+    TEST_ASSERT_EQUAL_size_t(UPLINK_BACKLOG_SIZE, uplink.getBacklogSize());
+    TEST_ASSERT_EQUAL_UINT32(3, uplink.getDroppedPoints());
+
+    while (uplink.millisUntilNext(writer.now) != UPLINK_IDLE) sendNext(uplink, writer);
+
+    TEST_ASSERT_EQUAL_INT(UPLINK_BACKLOG_SIZE + 1, writer.writes);
+    TEST_ASSERT_EQUAL_UINT32(added, writer.times[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, writer.times[1]);
+    TEST_ASSERT_EQUAL_UINT32(added - 1, writer.times[writer.writes - 1]);
+}
+
+void test_malformed_points_are_dropped()
+{
+    int codes[] = {400, 413, 422};
+    for (int code : codes)
+    {
+        TemperatureUplink uplink = createUplink();
+        StubWriter writer;
+        writer.fail(code, 1);
+        uplink.add(point(1000));
+
+        TEST_ASSERT_EQUAL_INT(code, send(uplink, writer));
+        TEST_ASSERT_EQUAL_UINT32(1, uplink.getRejectedPoints());
+        TEST_ASSERT_EQUAL_UINT32(0, uplink.getFailures());
+        TEST_ASSERT_EQUAL_UINT32(UPLINK_IDLE, uplink.millisUntilNext(writer.now));
+    }
+}
+
+void test_configuration_errors_keep_the_points()
+{
+    int codes[] = {401, 403, 404, 500, 502};
+    for (int code : codes)
+    {
+        TemperatureUplink uplink = createUplink();
+        StubWriter writer;
+        writer.fail(code, 3);
+        uplink.add(point(1000));
+
+        for (int i = 0; i < 3; i++) TEST_ASSERT_EQUAL_INT(code, sendNext(uplink, writer));
+        TEST_ASSERT_EQUAL_UINT32(3, uplink.getFailures());
+        TEST_ASSERT_EQUAL_UINT32(0, uplink.getRejectedPoints());
+        TEST_ASSERT_TRUE(uplink.millisUntilNext(writer.now) >= TEST_INITIAL_BACKOFF_MS * 4 / 2);
+
+        TEST_ASSERT_EQUAL_INT(204, sendNext(uplink, writer));
+        TEST_ASSERT_EQUAL_INT(1, writer.writes);
+        TEST_ASSERT_EQUAL_UINT32(1000, writer.times[0]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sends_a_point);
+    RUN_TEST(test_backoff_grows_until_the_cap);
+    RUN_TEST(test_backoff_starts_after_a_slow_write);
+    RUN_TEST(test_retry_after_is_a_floor);
+    RUN_TEST(test_fresh_point_before_the_backlog);
+    RUN_TEST(test_backfill_rate_is_capped);
+    RUN_TEST(test_full_backlog_drops_the_oldest);
+    RUN_TEST(test_malformed_points_are_dropped);
+    RUN_TEST(test_configuration_errors_keep_the_points);
+    return UNITY_END();
+}
@@ -0,0 +1,863 @@
+/**
+ * @brief Fleet Simulator
+ * @details This Programm is used to simulate many Temperature Transmitters against one InfluxDB
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Every virtual transmitter is a TemperatureTransmitter of the firmware with its TemperatureScheduler,
+ * TemperatureUplink and TemperatureLineProtocol, only the clock, the sensor, the WiFi and the writer are fakes. The
+ * writer sends the records over HTTP like the InfluxDB client of the firmware.
+ *
+ * The simulator is a closed loop: every upload thread owns one connection and writes
+ * synchronously like the firmware, so its devices wait while one of them writes. By default
+ * every device gets its own thread (up to SIMULATOR_MAX_THREADS). With fewer threads a slow
+ * server limits the offered load, the report warns if the threads were saturated.
+ *
+ * The write timeout, the latency and the Retry-After of the stub are simulated times, they are divided by the
+ * speedup. Above a speedup of about 100 they get close to the timer resolution of the kernel.
+ *
+ * Build (Linux):
+ *   g++ -std=c++17 -O2 -pthread -DLOG_LEVEL=0 -Itools/HostShim -Ilib/TemperatureFixedString \
+ *       -Ilib/TemperatureLineProtocol -Ilib/TemperatureRecordWriter -Ilib/TemperatureTransmitter \
+ *       -Ilib/TemperatureLogger -Ilib/TemperatureRingBuffer -Ilib/TemperatureScheduler -Ilib/TemperatureUplink \
+ *       tools/FleetSimulator/FleetSimulator.cpp \
+ *       lib/TemperatureLineProtocol/TemperatureLineProtocol.cpp \
+ *       lib/TemperatureScheduler/TemperatureScheduler.cpp \
+ *       lib/TemperatureUplink/TemperatureUplink.cpp \
+ *       lib/TemperatureTransmitter/TemperatureTransmitter.cpp -o fleet_simulator
+ *
+ * Run against the built-in stub:
+ *   ./fleet_simulator --devices 500 --speedup 60 --duration 3600 --stub 18086
+ *
+ * Run against a stub which answers 10% of the writes with 503 and Retry-After: 60:
+ *   ./fleet_simulator --devices 500 --stub 18086 --stub-error-rate 0.1 --stub-error-code 503 --stub-retry-after 60
+ *
+ * Run against a local InfluxDB:
+ *   ./fleet_simulator --devices 500 --url http://127.0.0.1:8086 --org my-org --bucket test --token ...
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "TemperatureLineProtocol.h"
+#include "TemperatureRecordWriter.h"
+#include "TemperatureScheduler.h"
+#include "TemperatureTransmitter.h"
+#include "TemperatureUplink.h"
+
+#define SIMULATOR_MEASUREMENT "TemperatureWifi"
+#define SIMULATOR_LATE_TOLERANCE_MS 2000
+#define SIMULATOR_MAX_THREADS 256
+
+// Same as UPLINK_CONNECT_BUDGET_MS of the firmware, the send guard adds the write timeout
+#define SIMULATOR_CONNECT_BUDGET_MS 10000
+
+// Share of the time a thread may spend in requests before its devices are delayed
+#define SIMULATOR_SATURATED_BUSY 0.5
+
+// ------ OPTIONS ------
+
+struct SimulatorOptions
+{
+    int devices = 100;
+    int threads = 0;
+    double speedup = 60;
+    double durationSeconds = 3600;
+    uint32_t samplePeriodMs = 60000;
+    uint32_t samplesPerUpload = 10;
+    uint32_t uploadJitterMs = 30000;
+    int batchSize = 1;
+    uint32_t writeTimeoutMs = 5000;
+    uint32_t initialBackoffMs = 5000;
+    uint32_t maxBackoffMs = 300000;
+    uint32_t backfillIntervalMs = 5000;
+    double outageEverySeconds = 0;
+    double outageLengthSeconds = 0;
+    double outageFraction = 1;
+    std::string url = "http://127.0.0.1:8086";
+    std::string org = "org";
+    std::string bucket = "bucket";
+    std::string token = "token";
+    int stubPort = 0;
+    int stubLatencyMs = 0;
+    double stubErrorRate = 0;
+    int stubErrorCode = 503;
+    int stubRetryAfterSeconds = 0;
+};
+
+/**
+ * @brief Print the usage
+ */
+static void printUsage()
+{
+    printf("Usage: fleet_simulator [options]\n"
+           "  --devices N             virtual transmitters (100)\n"
+           "  --threads N             upload threads, each owns one connection (0 = one per device, at most 256)\n"
+           "  --speedup X             simulated seconds per real second (60)\n"
+           "  --duration S            simulated duration in s (3600)\n"
+           "  --sample-period MS      time between samples (60000)\n"
+           "  --samples-per-upload N  samples averaged per point (10)\n"
+           "  --jitter MS             maximum upload jitter (30000)\n"
+           "  --batch N               points per write request, at most %d (1)\n"
+           "  --write-timeout MS      connect, send and receive timeout of a write like the HTTP client of the firmware (5000)\n"
+           "  --backoff MS            wait time after the first failed write (5000)\n"
+           "  --max-backoff MS        maximum wait time after failed writes (300000)\n"
+           "  --backfill-interval MS  minimum time between two older points (5000)\n"
+           "  --outage-every S        simulated s between WiFi outages (0 = none)\n"
+           "  --outage-length S       simulated length of an outage (0)\n"
+           "  --outage-fraction F     share of the devices affected by an outage (1)\n"
+           "  --url URL               InfluxDB base URL, http only (http://127.0.0.1:8086)\n"
+           "  --org, --bucket, --token  InfluxDB write parameters\n"
+           "  --stub PORT             start a stub InfluxDB on PORT and write to it\n"
+           "  --stub-latency MS       response latency of the stub (0)\n"
+           "  --stub-error-rate F     share of the writes the stub fails (0)\n"
+           "  --stub-error-code N     status code of the failed writes (503)\n"
+           "  --stub-retry-after S    Retry-After of the failed writes (0 = none)\n"
+           "All times are simulated times, they run --speedup times faster than the real time.\n",
+           TRANSMITTER_MAX_BATCH);
+}
+
+/**
+ * @brief Parse the command line
+ *
+ * @return true if the options are valid
+ */
+static bool parseOptions(int argc, char **argv, SimulatorOptions *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string name = argv[i];
+        if (name == "--help") return false;
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "Missing value for %s\n", name.c_str());
+            return false;
+        }
+        const char *value = argv[++i];
+
+        if (name == "--devices") options->devices = atoi(value);
+        else if (name == "--threads") options->threads = atoi(value);
+        else if (name == "--speedup") options->speedup = atof(value);
+        else if (name == "--duration") options->durationSeconds = atof(value);
+        else if (name == "--sample-period") options->samplePeriodMs = strtoul(value, nullptr, 10);
+        else if (name == "--samples-per-upload") options->samplesPerUpload = strtoul(value, nullptr, 10);
+        else if (name == "--jitter") options->uploadJitterMs = strtoul(value, nullptr, 10);
+        else if (name == "--batch") options->batchSize = atoi(value);
+        else if (name == "--write-timeout") options->writeTimeoutMs = strtoul(value, nullptr, 10);
+        else if (name == "--backoff") options->initialBackoffMs = strtoul(value, nullptr, 10);
+        else if (name == "--max-backoff") options->maxBackoffMs = strtoul(value, nullptr, 10);
+        else if (name == "--backfill-interval") options->backfillIntervalMs = strtoul(value, nullptr, 10);
+        else if (name == "--outage-every") options->outageEverySeconds = atof(value);
+        else if (name == "--outage-length") options->outageLengthSeconds = atof(value);
+        else if (name == "--outage-fraction") options->outageFraction = atof(value);
+        else if (name == "--url") options->url = value;
+        else if (name == "--org") options->org = value;
+        else if (name == "--bucket") options->bucket = value;
+        else if (name == "--token") options->token = value;
+        else if (name == "--stub") options->stubPort = atoi(value);
+        else if (name == "--stub-latency") options->stubLatencyMs = atoi(value);
+        else if (name == "--stub-error-rate") options->stubErrorRate = atof(value);
+        else if (name == "--stub-error-code") options->stubErrorCode = atoi(value);
+        else if (name == "--stub-retry-after") options->stubRetryAfterSeconds = atoi(value);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", name.c_str());
+            return false;
+        }
+    }
+
+    if (options->devices < 1 || options->threads < 0 || options->speedup <= 0 || options->batchSize < 1 ||
+        options->batchSize > TRANSMITTER_MAX_BATCH || options->writeTimeoutMs == 0 || options->stubLatencyMs < 0 ||
+        SIMULATOR_CONNECT_BUDGET_MS + options->writeTimeoutMs >= options->samplePeriodMs)
+    {
+        fprintf(stderr, "Invalid options\n");
+        return false;
+    }
+    if (options->threads == 0) options->threads = std::min(options->devices, SIMULATOR_MAX_THREADS);
+    if (options->threads > options->devices) options->threads = options->devices;
+    if (options->stubPort > 0) options->url = "http://127.0.0.1:" + std::to_string(options->stubPort);
+    return true;
+}
+
+// ------ FAKE CLOCK ------
+
+/**
+ * @brief Simulated wall clock, runs speedup times faster than the real clock, shared by all threads
+ */
+class FakeClock : public TemperatureClock
+{
+public:
+    FakeClock(double speedup)
+    {
+        this->speedup = speedup;
+        realStart = std::chrono::steady_clock::now();
+        simulatedStart = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    int64_t getUptime() override { return now() - simulatedStart; }
+    int64_t getWallClock() override { return now(); }
+
+    int64_t now() const
+    {
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - realStart).count();
+        return simulatedStart + (int64_t)(elapsed * speedup);
+    }
+
+    int64_t start() const { return simulatedStart; }
+
+    void sleepUntil(int64_t simulated) const
+    {
+        double realMs = (simulated - simulatedStart) / speedup;
+        std::this_thread::sleep_until(realStart + std::chrono::microseconds((int64_t)(realMs * 1000)));
+    }
+
+private:
+    double speedup;
+    std::chrono::steady_clock::time_point realStart;
+    int64_t simulatedStart;
+};
+
+// ------ FAKE SENSOR AND WIFI ------
+
+/**
+ * @brief Daily temperature curve with noise, NAN sometimes like a loose sensor
+ */
+class FakeSensor : public TemperatureSensor
+{
+public:
+    FakeSensor(uint32_t seed, const FakeClock *clock) : random(seed), noise(0, 0.1), offset(15 + seed % 10), clock(clock) {}
+
+    double read() override
+    {
+        if (random() % 1000 == 0) return NAN;
+        double day = (clock->now() / 1000 % 86400) / 86400.0;
+        return offset + 4 * sin(2 * M_PI * day) + noise(random);
+    }
+
+private:
+    std::mt19937 random;
+    std::normal_distribution<double> noise;
+    double offset;
+    const FakeClock *clock;
+};
+
+/**
+ * @brief WiFi which drops out periodically
+ */
+class FakeWifi : public TemperatureNetwork
+{
+public:
+    uint64_t reconnects = 0;
+
+    FakeWifi(const SimulatorOptions &options, const FakeClock *clock, bool affected)
+    {
+        this->clock = clock;
+        this->everyMs = (int64_t)(options.outageEverySeconds * 1000);
+        this->lengthMs = (int64_t)(options.outageLengthSeconds * 1000);
+        this->affected = affected && everyMs > 0 && lengthMs > 0;
+    }
+
+    bool hasWifi() override
+    {
+        if (!affected) return true;
+        return (clock->now() - clock->start()) % everyMs < everyMs - lengthMs;
+    }
+
+    // Like TemperatureWifiHelper::reconnect() it returns at once, the WiFi is back when the outage is over
+    void reconnect() override { reconnects++; }
+
+    long getRSSI() override { return -55 - (long)((clock->now() / 60000) % 20); }
+
+private:
+    const FakeClock *clock;
+    int64_t everyMs;
+    int64_t lengthMs;
+    bool affected;
+};
+
+// ------ HTTP ------
+
+struct HttpUrl
+{
+    std::string host;
+    std::string port;
+};
+
+/**
+ * @brief Split a http://host:port URL
+ */
+static bool parseUrl(const std::string &url, HttpUrl *result)
+{
+    const std::string scheme = "http://";
+    if (url.compare(0, scheme.size(), scheme) != 0) return false;
+    std::string rest = url.substr(scheme.size());
+    rest = rest.substr(0, rest.find('/'));
+    size_t colon = rest.find(':');
+    result->host = rest.substr(0, colon);
+    result->port = colon == std::string::npos ? "80" : rest.substr(colon + 1);
+    return !result->host.empty();
+}
+
+/**
+ * @brief Read until the end of the HTTP header
+ *
+ * @return size_t the length of the header including the empty line, 0 if the connection was closed
+ */
+static size_t readHeader(int socket, std::string *buffer)
+{
+    for (;;)
+    {
+        size_t end = buffer->find("\r\n\r\n");
+        if (end != std::string::npos) return end + 4;
+
+        char chunk[4096];
+        ssize_t received = recv(socket, chunk, sizeof(chunk), 0);
+        if (received <= 0) return 0;
+        buffer->append(chunk, received);
+    }
+}
+
+/**
+ * @brief Read a body of a known length after the header
+ */
+static bool readBody(int socket, std::string *buffer, size_t length)
+{
+    while (buffer->size() < length)
+    {
+        char chunk[4096];
+        ssize_t received = recv(socket, chunk, sizeof(chunk), 0);
+        if (received <= 0) return false;
+        buffer->append(chunk, received);
+    }
+    return true;
+}
+
+/**
+ * @brief Get a header value, case insensitive
+ */
+static std::string headerValue(const std::string &header, const char *name)
+{
+    std::string lower = header;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    std::string key = std::string("\r\n") + name + ":";
+    size_t position = lower.find(key);
+    if (position == std::string::npos) return "";
+    position += key.size();
+    size_t end = header.find("\r\n", position);
+    std::string value = header.substr(position, end - position);
+    value.erase(0, value.find_first_not_of(' '));
+    return value;
+}
+
+static bool sendAll(int socket, const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t written = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) return false;
+        sent += written;
+    }
+    return true;
+}
+
+/**
+ * @brief Keep-alive client for the InfluxDB v2 write API
+ */
+class InfluxWriter
+{
+public:
+    InfluxWriter(const SimulatorOptions &options, const HttpUrl &url) : url(url)
+    {
+        path = "/api/v2/write?org=" + options.org + "&bucket=" + options.bucket + "&precision=s";
+        token = options.token;
+        connection = -1;
+        sentBytes = 0;
+        receivedBytes = 0;
+
+        // The write timeout of the firmware in simulated time
+        int64_t timeoutUs = std::max<int64_t>(1000, (int64_t)(options.writeTimeoutMs * 1000.0 / options.speedup));
+        timeout.tv_sec = timeoutUs / 1000000;
+        timeout.tv_usec = timeoutUs % 1000000;
+    }
+
+    ~InfluxWriter() { disconnect(); }
+
+    /**
+     * @brief Write a body of line protocol, every call is one attempt and is never repeated
+     *
+     * @param retryAfterMs the Retry-After of the response, 0 if there was none
+     * @return int the HTTP status code, 0 if the server was not reachable or did not answer in time
+     */
+    int write(const std::string &body, uint32_t *retryAfterMs)
+    {
+        *retryAfterMs = 0;
+        // A request which was sent is not repeated, the server may have written it already
+        if (connection >= 0 && !isAlive()) disconnect();
+        if (connection < 0 && !connect()) return 0;
+
+        std::string request = "POST " + path + " HTTP/1.1\r\nHost: " + url.host +
+                              "\r\nAuthorization: Token " + token +
+                              "\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: " + std::to_string(body.size()) +
+                              "\r\nConnection: keep-alive\r\n\r\n" + body;
+        int status = 0;
+        sentBytes += request.size();
+        if (sendAll(connection, request) && readResponse(&status, retryAfterMs)) return status;
+
+        disconnect();
+        return 0;
+    }
+
+    /**
+     * @brief Get the bytes of all HTTP requests and responses, the TCP/IP headers are not counted
+     */
+    uint64_t getWireBytes() const { return sentBytes + receivedBytes; }
+
+private:
+    bool connect()
+    {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *addresses = nullptr;
+        if (getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &addresses) != 0) return false;
+
+        for (addrinfo *address = addresses; address != nullptr; address = address->ai_next)
+        {
+            connection = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (connection < 0) continue;
+
+            // On Linux the send timeout limits the connect too
+            setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            if (::connect(connection, address->ai_addr, address->ai_addrlen) == 0) break;
+            close(connection);
+            connection = -1;
+        }
+        freeaddrinfo(addresses);
+        if (connection < 0) return false;
+
+        int noDelay = 1;
+        setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return true;
+    }
+
+    void disconnect()
+    {
+        if (connection >= 0) close(connection);
+        connection = -1;
+    }
+
+    /**
+     * @brief Check that the server did not close the idle connection
+     */
+    bool isAlive()
+    {
+        char peek;
+        ssize_t received = recv(connection, &peek, 1, MSG_PEEK | MSG_DONTWAIT);
+        return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+
+    bool readResponse(int *status, uint32_t *retryAfterMs)
+    {
+        std::string buffer;
+        size_t headerLength = readHeader(connection, &buffer);
+        if (headerLength == 0 || sscanf(buffer.c_str(), "HTTP/1.%*d %d", status) != 1) return false;
+
+        std::string header = buffer.substr(0, headerLength);
+        std::string contentLength = headerValue(header, "content-length");
+        if (!contentLength.empty() && !readBody(connection, &buffer, headerLength + strtoul(contentLength.c_str(), nullptr, 10))) return false;
+        receivedBytes += buffer.size();
+        *retryAfterMs = strtoul(headerValue(header, "retry-after").c_str(), nullptr, 10) * 1000;
+        if (headerValue(header, "connection") == "close") disconnect();
+        return true;
+    }
+
+    HttpUrl url;
+    std::string path;
+    std::string token;
+    timeval timeout;
+    int connection;
+    uint64_t sentBytes;
+    uint64_t receivedBytes;
+};
+
+// ------ STUB SERVER ------
+
+/**
+ * @brief Minimal InfluxDB which accepts the writes or fails a share of them
+ */
+class StubServer
+{
+public:
+    StubServer(const SimulatorOptions &options)
+    {
+        this->port = options.stubPort;
+        this->latencyUs = (int64_t)(options.stubLatencyMs * 1000.0 / options.speedup);
+        this->errorRate = options.stubErrorRate;
+        this->errorCode = options.stubErrorCode;
+        this->retryAfterSeconds = options.stubRetryAfterSeconds;
+        listener = -1;
+    }
+
+    bool start()
+    {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0) return false;
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (bind(listener, (sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 1024) != 0) return false;
+
+        std::thread(&StubServer::acceptLoop, this).detach();
+        return true;
+    }
+
+    uint64_t getRequests() const { return requests; }
+    uint64_t getPoints() const { return points; }
+    uint64_t getErrors() const { return errors; }
+
+private:
+    void acceptLoop()
+    {
+        for (;;)
+        {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) return;
+            std::thread(&StubServer::serve, this, client).detach();
+        }
+    }
+
+    void serve(int client)
+    {
+        std::mt19937 random(client);
+        std::uniform_real_distribution<double> share(0, 1);
+        std::string buffer;
+        for (;;)
+        {
+            size_t headerLength = readHeader(client, &buffer);
+            if (headerLength == 0) break;
+            size_t bodyLength = strtoul(headerValue(buffer.substr(0, headerLength), "content-length").c_str(), nullptr, 10);
+            if (!readBody(client, &buffer, headerLength + bodyLength)) break;
+
+            requests++;
+            uint64_t received = std::count(buffer.begin() + headerLength, buffer.begin() + headerLength + bodyLength, '\n') + 1;
+            buffer.erase(0, headerLength + bodyLength);
+
+            // The latency is simulated time like all other times
+            if (latencyUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(latencyUs));
+            if (share(random) < errorRate)
+            {
+                errors++;
+                if (!sendAll(client, errorResponse())) break;
+                continue;
+            }
+
+            points += received;
+            if (!sendAll(client, "HTTP/1.1 204 No Content\r\n\r\n")) break;
+        }
+        close(client);
+    }
+
+    std::string errorResponse()
+    {
+        std::string body = "{\"code\":\"unavailable\",\"message\":\"injected by the stub\"}";
+        std::string response = "HTTP/1.1 " + std::to_string(errorCode) + " Error\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+        if (retryAfterSeconds > 0) response += "Retry-After: " + std::to_string(retryAfterSeconds) + "\r\n";
+        return response + "\r\n" + body;
+    }
+
+    int port;
+    int64_t latencyUs;
+    double errorRate;
+    int errorCode;
+    int retryAfterSeconds;
+    int listener;
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> points{0};
+    std::atomic<uint64_t> errors{0};
+};
+
+// ------ TRANSMITTER ------
+
+struct SimulatorStatistics
+{
+    std::vector<double> requestLatenciesMs;
+    std::vector<double> endToEndMs;
+    uint64_t requests = 0;
+    uint64_t failedRequests = 0;
+    uint64_t points = 0;
+    uint64_t droppedPoints = 0;
+    uint64_t rejectedPoints = 0;
+    uint64_t queuedPoints = 0;
+    uint64_t reconnects = 0;
+    uint64_t bodyBytes = 0;
+    uint64_t wireBytes = 0;
+    uint64_t skippedSlots = 0;
+    int64_t maxLagMs = 0;
+
+    void add(const SimulatorStatistics &other)
+    {
+        requestLatenciesMs.insert(requestLatenciesMs.end(), other.requestLatenciesMs.begin(), other.requestLatenciesMs.end());
+        endToEndMs.insert(endToEndMs.end(), other.endToEndMs.begin(), other.endToEndMs.end());
+        requests += other.requests;
+        failedRequests += other.failedRequests;
+        points += other.points;
+        droppedPoints += other.droppedPoints;
+        rejectedPoints += other.rejectedPoints;
+        queuedPoints += other.queuedPoints;
+        reconnects += other.reconnects;
+        bodyBytes += other.bodyBytes;
+        wireBytes += other.wireBytes;
+        skippedSlots += other.skippedSlots;
+        maxLagMs = std::max(maxLagMs, other.maxLagMs);
+    }
+};
+
+/**
+ * @brief The writer of the transmitters of one thread, sends over its connection and records the statistics
+ */
+class SimulatorWriter : public TemperatureRecordWriter
+{
+public:
+    SimulatorWriter(const SimulatorOptions &options, const HttpUrl &url, const FakeClock *clock, SimulatorStatistics *statistics)
+        : influxWriter(options, url)
+    {
+        this->clock = clock;
+        this->statistics = statistics;
+        this->lastSampleMs = (int64_t)(options.samplesPerUpload - 1) * options.samplePeriodMs;
+    }
+
+    int write(const char *records, uint32_t *retryAfterMs) override
+    {
+        std::string body = records;
+        auto requestStart = std::chrono::steady_clock::now();
+        int status = influxWriter.write(body, retryAfterMs);
+        double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - requestStart).count();
+
+        statistics->requests++;
+        statistics->requestLatenciesMs.push_back(latency);
+        if (status < 200 || status >= 300)
+        {
+            statistics->failedRequests++;
+            return status;
+        }
+
+        // The latency starts with the last sample of the group and ends after the response,
+        // so it includes the jitter, the backoff, the backfill and the outages
+        int64_t now = clock->now();
+        statistics->bodyBytes += body.size();
+        for (size_t line = 0; line < body.size(); line = body.find('\n', line) + 1)
+        {
+            size_t end = std::min(body.find('\n', line), body.size());
+            int64_t time = strtoll(body.c_str() + body.rfind(' ', end - 1) + 1, nullptr, 10);
+            statistics->points++;
+            statistics->endToEndMs.push_back((double)(now - (time * 1000 + lastSampleMs)));
+            if (end == body.size()) break;
+        }
+        return status;
+    }
+
+    uint64_t getWireBytes() const { return influxWriter.getWireBytes(); }
+
+private:
+    InfluxWriter influxWriter;
+    const FakeClock *clock;
+    SimulatorStatistics *statistics;
+    int64_t lastSampleMs;
+};
+
+/**
+ * @brief One virtual Temperature Transmitter, the TemperatureTransmitter of the firmware with fakes around it
+ */
+class VirtualTransmitter
+{
+public:
+    VirtualTransmitter(const SimulatorOptions &options, int index, FakeClock *clock, bool outage, SimulatorWriter *writer)
+        : scheduler(options.samplePeriodMs, options.samplesPerUpload, options.uploadJitterMs, SIMULATOR_LATE_TOLERANCE_MS, 0x5eed0000ULL + index),
+          uplink(options.initialBackoffMs, options.maxBackoffMs, options.backfillIntervalMs, 0x5eed0000ULL + index),
+          lineProtocol(SIMULATOR_MEASUREMENT),
+          sensor(index, clock),
+          wifi(options, clock, outage),
+          transmitter(&scheduler, &uplink, options.batchSize, SIMULATOR_CONNECT_BUDGET_MS + options.writeTimeoutMs, &lineProtocol, clock, &sensor, &wifi, writer)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "sim-%05d", index);
+        lineProtocol.addTag("device", name);
+    }
+
+    /**
+     * @brief Run the transmitter like loop() in main.cpp
+     *
+     * @return uint32_t the time in ms until it has to run again
+     */
+    uint32_t run() { return transmitter.run(); }
+
+    /**
+     * @brief Add the counters which are kept by the transmitter
+     */
+    void finish(SimulatorStatistics *statistics)
+    {
+        statistics->skippedSlots += scheduler.getSkippedSlots();
+        statistics->droppedPoints += uplink.getDroppedPoints();
+        statistics->rejectedPoints += uplink.getRejectedPoints();
+        statistics->queuedPoints += uplink.getBacklogSize();
+        statistics->reconnects += wifi.reconnects;
+    }
+
+private:
+    TemperatureScheduler scheduler;
+    TemperatureUplink uplink;
+    TemperatureLineProtocol lineProtocol;
+    FakeSensor sensor;
+    FakeWifi wifi;
+    TemperatureTransmitter transmitter;
+};
+
+// ------ SIMULATION ------
+
+/**
+ * @brief Run a share of the fleet on one thread with one connection
+ */
+static void runWorker(const SimulatorOptions &options, const HttpUrl &url, FakeClock *clock, int worker, SimulatorStatistics *statistics)
+{
+    int64_t end = clock->start() + (int64_t)(options.durationSeconds * 1000);
+    SimulatorWriter writer(options, url, clock, statistics);
+    std::vector<std::unique_ptr<VirtualTransmitter>> transmitters;
+    std::mt19937 random(worker);
+    std::uniform_real_distribution<double> share(0, 1);
+    for (int i = worker; i < options.devices; i += options.threads)
+        transmitters.emplace_back(new VirtualTransmitter(options, i, clock, share(random) < options.outageFraction, &writer));
+
+    typedef std::pair<int64_t, size_t> Event;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    for (size_t i = 0; i < transmitters.size(); i++) events.push(Event(clock->start(), i));
+
+    while (!events.empty() && events.top().first < end)
+    {
+        Event event = events.top();
+        events.pop();
+
+        clock->sleepUntil(event.first);
+        statistics->maxLagMs = std::max(statistics->maxLagMs, clock->now() - event.first);
+
+        // The transmitters run on simulated time, a slow server shows up as lag and late wakeups
+        uint32_t wait = transmitters[event.second]->run();
+        events.push(Event(clock->now() + wait, event.second));
+    }
+
+    for (std::unique_ptr<VirtualTransmitter> &transmitter : transmitters) transmitter->finish(statistics);
+    statistics->wireBytes = writer.getWireBytes();
+}
+
+static double percentile(std::vector<double> &values, double rank)
+{
+    if (values.empty()) return 0;
+    size_t index = std::min(values.size() - 1, (size_t)(rank * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static void printPercentiles(const char *name, std::vector<double> &values, double scale)
+{
+    printf("%-26s p50 %10.1f  p90 %10.1f  p99 %10.1f  max %10.1f\n", name,
+           percentile(values, 0.5) * scale, percentile(values, 0.9) * scale,
+           percentile(values, 0.99) * scale, percentile(values, 1.0) * scale);
+}
+
+// ------ MAIN ------
+
+int main(int argc, char **argv)
+{
+    SimulatorOptions options;
+    if (!parseOptions(argc, argv, &options))
+    {
+        printUsage();
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    HttpUrl url;
+    if (!parseUrl(options.url, &url))
+    {
+        fprintf(stderr, "Only http://host:port URLs are supported\n");
+        return 1;
+    }
+
+    StubServer stub(options);
+    if (options.stubPort > 0 && !stub.start())
+    {
+        fprintf(stderr, "Could not start the stub on port %d\n", options.stubPort);
+        return 1;
+    }
+
+    printf("Simulating %d transmitters on %d threads for %.0f s at %.0fx against %s\n", options.devices, options.threads,
+           options.durationSeconds, options.speedup, options.url.c_str());
+
+    FakeClock clock(options.speedup);
+    std::vector<SimulatorStatistics> workerStatistics(options.threads);
+    std::vector<std::thread> workers;
+    auto realStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.threads; i++)
+        workers.emplace_back(runWorker, std::cref(options), std::cref(url), &clock, i, &workerStatistics[i]);
+    for (std::thread &worker : workers) worker.join();
+    double realSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+
+    SimulatorStatistics total;
+    for (SimulatorStatistics &statistics : workerStatistics) total.add(statistics);
+    double simulatedSeconds = realSeconds * options.speedup;
+    double requestMs = 0;
+    for (double latency : total.requestLatenciesMs) requestMs += latency;
+    double busy = requestMs / (options.threads * realSeconds * 1000);
+
+    printf("\n");
+    printf("%-26s %llu (%llu failed)\n", "Requests", (unsigned long long)total.requests, (unsigned long long)total.failedRequests);
+    printf("%-26s %llu (%llu dropped, %llu rejected, %llu still queued, %llu skipped slots)\n", "Points", (unsigned long long)total.points,
+           (unsigned long long)total.droppedPoints, (unsigned long long)total.rejectedPoints, (unsigned long long)total.queuedPoints, (unsigned long long)total.skippedSlots);
+    // The wire bytes include the HTTP headers of the requests and responses and the failed writes
+    printf("%-26s %.1f body, %.1f HTTP requests and responses\n", "Bytes/point", total.points > 0 ? (double)total.bodyBytes / total.points : 0.0,
+           total.points > 0 ? (double)total.wireBytes / total.points : 0.0);
+    printf("%-26s %.1f real, %.3f simulated\n", "Requests/s", total.requests / realSeconds, total.requests / simulatedSeconds);
+    printf("%-26s %.1f real, %.3f simulated\n", "Points/s", total.points / realSeconds, total.points / simulatedSeconds);
+    printPercentiles("Request latency (ms)", total.requestLatenciesMs, options.speedup);
+    printPercentiles("End-to-end latency (s)", total.endToEndMs, 0.001);
+    printf("%-26s %lld ms simulated\n", "Max scheduling lag", (long long)total.maxLagMs);
+    printf("%-26s %llu\n", "WiFi reconnects", (unsigned long long)total.reconnects);
+    printf("%-26s %.1f%% in requests\n", "Upload threads busy", busy * 100);
+    if (options.stubPort > 0)
+        printf("%-26s %llu requests, %llu points, %llu injected errors\n", "Stub received", (unsigned long long)stub.getRequests(),
+               (unsigned long long)stub.getPoints(), (unsigned long long)stub.getErrors());
+
+    // With one thread per device a slow server delays only the device which waits for it, like on the real fleet
+    if (options.threads < options.devices && (busy > SIMULATOR_SATURATED_BUSY || total.maxLagMs > SIMULATOR_LATE_TOLERANCE_MS))
+        printf("\nWARNING: the upload threads were saturated, the results are limited by --threads %d. "
+               "Use more threads or a lower --speedup.\n", options.threads);
+    return 0;
+}
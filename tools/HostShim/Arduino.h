@@ -0,0 +1,127 @@
+/**
+ * @brief Host Shim
+ * @details This Programm is used to build the Arduino dependent libraries on Linux for the host tools
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Only what the libraries use is provided. xTaskCreate() does not start a task, the tools
+ * call TemperatureLogger::drain() themselves. The Serial behaves like the Print class of the
+ * ESP32 core, so the host tools see the same heap use: printf() formats into a 64 byte
+ * buffer on the stack and allocates a bigger one for longer output.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <atomic>
+#include <chrono>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// FreeRTOS
+typedef void *TaskHandle_t;
+#define tskIDLE_PRIORITY 0
+#define pdMS_TO_TICKS(ms) (ms)
+
+inline void vTaskDelay(uint32_t ticks) { (void)ticks; }
+
+inline int xTaskCreate(void (*task)(void *), const char *name, uint32_t stackSize, void *parameter, unsigned priority, TaskHandle_t *handle)
+{
+    (void)task;
+    (void)name;
+    (void)stackSize;
+    (void)parameter;
+    (void)priority;
+    *handle = (TaskHandle_t)1;
+    return 1;
+}
+
+// Set to a time in milliseconds to stop the clock of millis(), -1 uses the steady clock
+inline std::atomic<int64_t> hostMillis{-1};
+
+inline unsigned long millis()
+{
+    int64_t fixed = hostMillis.load(std::memory_order_relaxed);
+    if (fixed >= 0) return (unsigned long)fixed;
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Serial which counts the bytes and prints them only if an output is set
+ */
+class HostSerial
+{
+public:
+    FILE *output = nullptr;
+    size_t bytes = 0;
+
+    size_t write(const uint8_t *buffer, size_t size)
+    {
+        bytes += size;
+        if (output != nullptr) fwrite(buffer, 1, size, output);
+        return size;
+    }
+
+    int printf(const char *format, ...)
+    {
+        char localBuffer[64];
+        char *buffer = localBuffer;
+        va_list arguments;
+        va_start(arguments, format);
+        va_list copy;
+        va_copy(copy, arguments);
+        int length = vsnprintf(localBuffer, sizeof(localBuffer), format, copy);
+        va_end(copy);
+        if (length < 0)
+        {
+            va_end(arguments);
+            return length;
+        }
+        if ((size_t)length >= sizeof(localBuffer))
+        {
+            buffer = (char *)malloc(length + 1);
+            if (buffer == nullptr)
+            {
+                va_end(arguments);
+                return 0;
+            }
+            vsnprintf(buffer, length + 1, format, arguments);
+        }
+        va_end(arguments);
+        write((const uint8_t *)buffer, length);
+        if (buffer != localBuffer) free(buffer);
+        return length;
+    }
+
+    size_t print(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+    size_t print(long value) { return printNumber("%ld", value); }
+    size_t print(int value) { return print((long)value); }
+    size_t print(double value) { return printNumber("%.2f", value); }
+    size_t println() { return print("\r\n"); }
+
+    template <typename T>
+    size_t println(T value)
+    {
+        size_t size = print(value);
+        return size + println();
+    }
+
+private:
+    template <typename T>
+    size_t printNumber(const char *format, T value)
+    {
+        char buffer[33];
+        int length = snprintf(buffer, sizeof(buffer), format, value);
+        return length > 0 ? write((const uint8_t *)buffer, length) : 0;
+    }
+};
+
+inline HostSerial Serial;
+
+#endif
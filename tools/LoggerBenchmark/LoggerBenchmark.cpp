@@ -0,0 +1,181 @@
+/**
+ * @brief Logger Benchmark
+ * @details This Programm is used to measure how long the loop is blocked by a call of the TemperatureLogger
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Measures TemperatureLogger::write(), which copies the record and pushes it into the ring
+ * buffer, for every value type and for the paths where the record is dropped. millis() is
+ * driven by the benchmark through hostMillis of the host shim, so the rate limit of
+ * LOG_MAX_RECORDS_PER_SECOND only drops records in the scenarios which want it. The
+ * Serial of the shim counts the bytes without printing them.
+ *
+ * Scenarios:
+ *   number, decimal, text, secret  the record is accepted, drained every LOG_BUFFER_SIZE / 2 calls
+ *   rate limited                   more than LOG_MAX_RECORDS_PER_SECOND records in one second
+ *   buffer full                    the buffer is never drained
+ *   concurrent drain               a second thread drains and prints while the records are pushed
+ *
+ * The max column includes the preemptions of the host, the mean and p99 are the cost of the call.
+ *
+ * Build (Linux):
+ *   g++ -std=c++17 -O2 -pthread -Itools/HostShim -Ilib/TemperatureLineProtocol \
+ *       -Ilib/TemperatureFixedString -Ilib/TemperatureLogger -Ilib/TemperatureRingBuffer \
+ *       tools/LoggerBenchmark/LoggerBenchmark.cpp lib/TemperatureLogger/TemperatureLogger.cpp \
+ *       -o logger_benchmark
+ *
+ * Run:
+ *   ./logger_benchmark --calls 1000000
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "TemperatureLogger.h"
+
+#define BENCHMARK_RECORD "TemperatureWifi,device=ESP32-24A160123456 temperature=21.50,rssid=-60i 1700000000"
+#define BENCHMARK_TOKEN "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+
+// millis() advances by this much per call, so the rate limit is never reached
+#define BENCHMARK_STEP_MS (1000 / LOG_MAX_RECORDS_PER_SECOND)
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+/**
+ * @brief The times of all calls of one scenario
+ */
+class BenchmarkResult
+{
+public:
+    explicit BenchmarkResult(const char *name, size_t calls) : name(name) { times.reserve(calls); }
+
+    void add(BenchmarkClock::duration time) { times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()); }
+
+    void print(uint32_t dropped)
+    {
+        if (times.empty()) return;
+        std::sort(times.begin(), times.end());
+        double sum = 0;
+        for (int64_t time : times) sum += time;
+        printf("%-18s %10zu %10.1f %10lld %10lld %10lld %10lu\n", name, times.size(), sum / times.size(),
+               (long long)times[times.size() / 2], (long long)times[times.size() * 99 / 100], (long long)times.back(),
+               (unsigned long)dropped);
+    }
+
+private:
+    const char *name;
+    std::vector<int64_t> times;
+};
+
+/**
+ * @brief Empty the buffer and reset the rate limit, the records of the scenario before are not counted
+ */
+static uint32_t resetLogger()
+{
+    hostMillis += 1000;
+    logger.drain();
+    return logger.getDroppedRecords();
+}
+
+/**
+ * @brief Measure one call of the logger in a loop
+ *
+ * @param name the name of the scenario
+ * @param calls the number of calls
+ * @param stepMs how far millis() advances per call
+ * @param drainEvery drain the buffer after this many calls, 0 for never
+ * @param call the call to measure
+ */
+template <typename Call>
+static void runScenario(const char *name, size_t calls, int64_t stepMs, size_t drainEvery, Call call)
+{
+    uint32_t startDropped = resetLogger();
+    BenchmarkResult result(name, calls);
+
+    for (size_t i = 0; i < calls; i++)
+    {
+        hostMillis += stepMs;
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        call(i);
+        result.add(BenchmarkClock::now() - start);
+        if (drainEvery > 0 && (i + 1) % drainEvery == 0) logger.drain();
+    }
+
+    result.print(logger.getDroppedRecords() - startDropped);
+}
+
+/**
+ * @brief Push records while a second thread drains the buffer like the drain task
+ *
+ * @param calls the number of calls
+ */
+static void runConcurrentScenario(size_t calls)
+{
+    uint32_t startDropped = resetLogger();
+    BenchmarkResult result("concurrent drain", calls);
+    std::atomic<bool> running{true};
+
+    std::thread drainThread([&running]() {
+        while (running.load()) logger.drain();
+        logger.drain();
+    });
+
+    for (size_t i = 0; i < calls; i++)
+    {
+        hostMillis += BENCHMARK_STEP_MS;
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        logInfo(LOG_INFLUX, "Writing", BENCHMARK_RECORD);
+        result.add(BenchmarkClock::now() - start);
+    }
+
+    running = false;
+    drainThread.join();
+    result.print(logger.getDroppedRecords() - startDropped);
+}
+
+int main(int argc, char **argv)
+{
+    size_t calls = 1000000;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--calls") == 0) calls = strtoull(argv[i + 1], nullptr, 10);
+    }
+
+    hostMillis = 0;
+    logger.begin();
+
+    printf("Logger benchmark: %zu calls per scenario, record %zu bytes, buffer %d records\n",
+           calls, sizeof(TemperatureLogRecord), LOG_BUFFER_SIZE);
+    printf("%-18s %10s %10s %10s %10s %10s %10s\n", "Scenario", "Calls", "Mean ns", "p50 ns", "p99 ns", "Max ns", "Dropped");
+
+    runScenario("number", calls, BENCHMARK_STEP_MS, LOG_BUFFER_SIZE / 2, [](size_t i) {
+        logInfo(LOG_WIFI, "RSSI", (long)i);
+    });
+    runScenario("decimal", calls, BENCHMARK_STEP_MS, LOG_BUFFER_SIZE / 2, [](size_t i) {
+        logInfo(LOG_SENSOR, "Measured Temperature in °C", 20 + (i % 100) / 10.0);
+    });
+    runScenario("text", calls, BENCHMARK_STEP_MS, LOG_BUFFER_SIZE / 2, [](size_t) {
+        logInfo(LOG_INFLUX, "Writing", BENCHMARK_RECORD);
+    });
+    runScenario("secret", calls, BENCHMARK_STEP_MS, LOG_BUFFER_SIZE / 2, [](size_t) {
+        logInfo(LOG_CONF, "Token", logSecret(BENCHMARK_TOKEN));
+    });
+    runScenario("rate limited", calls, 0, LOG_BUFFER_SIZE / 2, [](size_t) {
+        logInfo(LOG_INFLUX, "Writing", BENCHMARK_RECORD);
+    });
+    runScenario("buffer full", calls, BENCHMARK_STEP_MS, 0, [](size_t) {
+        logInfo(LOG_INFLUX, "Writing", BENCHMARK_RECORD);
+    });
+    runConcurrentScenario(calls);
+
+    printf("Serial bytes %zu\n", Serial.bytes);
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * @brief Soak Test
+ * @details This Programm is used to check that the measure and upload loop does not use the heap
+ * @author agent
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * Drives the TemperatureTransmitter of the firmware for millions of simulated sample cycles:
+ * TemperatureScheduler -> sample -> average -> TemperatureUplink -> TemperatureLineProtocol::encode -> TemperatureRecordWriter, with logging
+ * through the TemperatureLogger. Only the clock, the sensor, the WiFi and the writer are fakes,
+ * the writer fails some writes and the WiFi drops out from time to time. malloc and operator
+ * new are counted, the test fails if a cycle after the warmup allocates or if the peak heap
+ * grows.
+ *
+ * The InfluxDB client behind TemperatureInfluxWriter is not covered, it still uses the heap
+ * for its write buffer and the HTTP request on the device.
+ *
+ * Build (Linux, glibc):
+ *   g++ -std=c++17 -O2 -Itools/HostShim -Ilib/TemperatureFixedString -Ilib/TemperatureLineProtocol \
+ *       -Ilib/TemperatureRecordWriter -Ilib/TemperatureTransmitter -Ilib/TemperatureLogger \
+ *       -Ilib/TemperatureRingBuffer -Ilib/TemperatureScheduler -Ilib/TemperatureUplink tools/SoakTest/SoakTest.cpp \
+ *       lib/TemperatureLineProtocol/TemperatureLineProtocol.cpp \
+ *       lib/TemperatureScheduler/TemperatureScheduler.cpp \
+ *       lib/TemperatureUplink/TemperatureUplink.cpp \
+ *       lib/TemperatureTransmitter/TemperatureTransmitter.cpp \
+ *       lib/TemperatureLogger/TemperatureLogger.cpp -o soak_test
+ *
+ * Run:
+ *   ./soak_test --cycles 5000000
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <new>
+
+#include "TemperatureLineProtocol.h"
+#include "TemperatureLogger.h"
+#include "TemperatureRecordWriter.h"
+#include "TemperatureScheduler.h"
+#include "TemperatureTransmitter.h"
+#include "TemperatureUplink.h"
+
+#define SOAK_SAMPLE_PERIOD_MS 60000
+#define SOAK_SAMPLES_PER_UPLOAD 10
+#define SOAK_UPLOAD_JITTER_MS 30000
+#define SOAK_LATE_TOLERANCE_MS 2000
+#define SOAK_DEVICE_SEED 0x24a160123456ULL
+// More than one point per write, so joining the records is covered too
+#define SOAK_BATCH_SIZE 2
+#define SOAK_INITIAL_BACKOFF_MS 5000
+#define SOAK_MAX_BACKOFF_MS 300000
+#define SOAK_BACKFILL_INTERVAL_MS 5000
+#define SOAK_SEND_GUARD_MS 15000
+
+// 2023-11-14 22:13:20 UTC, the clock is synced from the start
+#define SOAK_START_MS 1700000000000LL
+
+// ------ HEAP COUNTING ------
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+extern "C" void __libc_free(void *pointer);
+
+static std::atomic<uint64_t> allocations{0};
+static std::atomic<int64_t> heapBytes{0};
+static std::atomic<int64_t> peakHeapBytes{0};
+
+static void countAllocation(void *pointer)
+{
+    if (pointer == nullptr) return;
+    allocations++;
+    int64_t bytes = heapBytes += malloc_usable_size(pointer);
+    int64_t peak = peakHeapBytes.load();
+    while (bytes > peak && !peakHeapBytes.compare_exchange_weak(peak, bytes)) {}
+}
+
+static void countFree(void *pointer)
+{
+    if (pointer != nullptr) heapBytes -= malloc_usable_size(pointer);
+}
+
+extern "C" void *malloc(size_t size)
+{
+    void *pointer = __libc_malloc(size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    void *pointer = __libc_calloc(count, size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    countFree(pointer);
+    void *result = __libc_realloc(pointer, size);
+    countAllocation(result != nullptr ? result : (size == 0 ? nullptr : pointer));
+    return result;
+}
+
+extern "C" void free(void *pointer)
+{
+    countFree(pointer);
+    __libc_free(pointer);
+}
+
+void *operator new(size_t size)
+{
+    void *pointer = malloc(size);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *pointer) noexcept { free(pointer); }
+void operator delete[](void *pointer) noexcept { free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { free(pointer); }
+
+// ------ FAKES ------
+
+/**
+ * @brief Clock which jumps to the time the transmitter waits for
+ */
+class FakeClock : public TemperatureClock
+{
+public:
+    int64_t now = SOAK_START_MS;
+
+    int64_t getUptime() override { return now - SOAK_START_MS; }
+    int64_t getWallClock() override { return now; }
+};
+
+/**
+ * @brief Sensor with a deterministic noise, sometimes disconnected
+ */
+class FakeSensor : public TemperatureSensor
+{
+public:
+    FakeClock *clock;
+
+    explicit FakeSensor(FakeClock *clock) : clock(clock) {}
+
+    double read() override
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        if ((state >> 33) % 500 == 0) return NAN;
+        return 20 + 3 * sin((clock->now / 1000 % 86400) / 86400.0 * 2 * M_PI) + ((state >> 40) % 100) / 1000.0;
+    }
+
+private:
+    uint64_t state = 1;
+};
+
+/**
+ * @brief WiFi which is gone for 3 hours every 2 days, a reconnect does not help, the points wait in the uplink
+ */
+class FakeNetwork : public TemperatureNetwork
+{
+public:
+    FakeClock *clock;
+    uint64_t reconnects = 0;
+
+    explicit FakeNetwork(FakeClock *clock) : clock(clock) {}
+
+    bool hasWifi() override { return clock->now % (48 * 3600000LL) >= 3 * 3600000LL; }
+    void reconnect() override { reconnects++; }
+    long getRSSI() override { return -55 - (long)(clock->now / 60000 % 20); }
+};
+
+/**
+ * @brief Writer which loses the connection for 300 writes every 5000 writes and sends 503 sometimes
+ */
+class FakeWriter : public TemperatureRecordWriter
+{
+public:
+    uint64_t writes = 0;
+    uint64_t bytes = 0;
+
+    int write(const char *records, uint32_t *retryAfterMs) override
+    {
+        writes++;
+        bytes += strlen(records);
+        *retryAfterMs = 0;
+        if (writes % 5000 < 300) return 0;
+        if (writes % 997 == 0)
+        {
+            *retryAfterMs = 60000;
+            return 503;
+        }
+        return 204;
+    }
+};
+
+// ------ MAIN ------
+
+static FakeClock fakeClock;
+static FakeSensor fakeSensor(&fakeClock);
+static FakeNetwork fakeNetwork(&fakeClock);
+static FakeWriter fakeWriter;
+static TemperatureLineProtocol lineProtocol("TemperatureWifi");
+static TemperatureScheduler scheduler(SOAK_SAMPLE_PERIOD_MS, SOAK_SAMPLES_PER_UPLOAD, SOAK_UPLOAD_JITTER_MS, SOAK_LATE_TOLERANCE_MS, SOAK_DEVICE_SEED);
+static TemperatureUplink uplink(SOAK_INITIAL_BACKOFF_MS, SOAK_MAX_BACKOFF_MS, SOAK_BACKFILL_INTERVAL_MS, SOAK_DEVICE_SEED);
+static TemperatureTransmitter transmitter(&scheduler, &uplink, SOAK_BATCH_SIZE, SOAK_SEND_GUARD_MS, &lineProtocol,
+                                          &fakeClock, &fakeSensor, &fakeNetwork, &fakeWriter);
+
+/**
+ * @brief One cycle, the clock jumps over the wait like delay() in loop() and the drain task prints
+ */
+static void runCycle()
+{
+    hostMillis = fakeClock.getUptime();
+    fakeClock.now += transmitter.run();
+    logger.drain();
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t cycles = 2000000;
+    uint64_t warmup = 10000;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--cycles") == 0) cycles = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--warmup") == 0) warmup = strtoull(argv[i + 1], nullptr, 10);
+    }
+
+    // stdout allocates its buffer on the first print
+    printf("Soak test: %llu cycles after %llu warmup cycles\n", (unsigned long long)cycles, (unsigned long long)warmup);
+    fflush(stdout);
+
+    lineProtocol.addTag("device", "ESP32");
+    logger.begin();
+    for (uint64_t i = 0; i < warmup; i++) runCycle();
+
+    uint64_t startAllocations = allocations.load();
+    int64_t startPeak = peakHeapBytes.load();
+
+    for (uint64_t i = 0; i < cycles; i++) runCycle();
+
+    uint64_t cycleAllocations = allocations.load() - startAllocations;
+    int64_t peakGrowth = peakHeapBytes.load() - startPeak;
+
+    printf("Simulated time             %.1f days (%lu skipped slots)\n", fakeClock.getUptime() / 86400000.0, (unsigned long)scheduler.getSkippedSlots());
+    printf("Writes                     %llu (%llu bytes, %lu failed)\n", (unsigned long long)fakeWriter.writes,
+           (unsigned long long)fakeWriter.bytes, (unsigned long)transmitter.getFailedWrites());
+    printf("Points dropped             %lu (%zu queued, %llu reconnects)\n", (unsigned long)uplink.getDroppedPoints(), uplink.getBacklogSize(),
+           (unsigned long long)fakeNetwork.reconnects);
+    printf("Log bytes                  %zu (%lu records dropped)\n", Serial.bytes, (unsigned long)logger.getDroppedRecords());
+    printf("Allocations                %llu (%.6f per cycle)\n", (unsigned long long)cycleAllocations, cycles > 0 ? (double)cycleAllocations / cycles : 0.0);
+    printf("Peak heap growth           %lld bytes\n", (long long)peakGrowth);
+
+    if (cycleAllocations > 0 || peakGrowth > 0)
+    {
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}